@@ -0,0 +1,566 @@
+#include "BSplineCurves3.h"
+
+#include "../Core/BandedSquareMatrices.h"
+#include "../Core/Exceptions.h"
+#include "../Core/RealSquareMatrices.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+namespace cagd {
+BSplineCurve3::BSplineCurve3(GLuint degree, GLuint data_count, GLdouble u_min,
+                             GLdouble u_max, GLenum data_usage_flag)
+    : LinearCombinationEngine3<BSplineCurve3>(u_min, u_max, data_count,
+                                              data_usage_flag)
+    , _p(degree)
+    , _knot_vector(data_count + degree + 1)
+    , _hodographs_are_up_to_date(GL_FALSE)
+    , _hodograph_data_revision(0)
+{
+    if (degree > maximum_degree || data_count <= degree || !(u_min < u_max)) {
+        throw Exception("BSplineCurve3::BSplineCurve3 - Wrong degree, number "
+                        "of control points or definition domain.");
+    }
+
+    GLuint   n      = data_count;
+    GLdouble u_step = (u_max - u_min) / (n - _p);
+
+    for (GLuint i = 0; i <= n + _p; ++i) {
+        if (i <= _p) {
+            _knot_vector[i] = u_min;
+        } else if (i >= n) {
+            _knot_vector[i] = u_max;
+        } else {
+            _knot_vector[i] = u_min + (i - _p) * u_step;
+        }
+    }
+}
+
+BSplineCurve3::BSplineCurve3(GLuint                        degree,
+                             const ColumnMatrix<GLdouble> &knot_vector,
+                             GLenum                        data_usage_flag)
+    : LinearCombinationEngine3<BSplineCurve3>(
+          0.0, 1.0,
+          knot_vector.GetRowCount() > degree + 1
+              ? knot_vector.GetRowCount() - degree - 1
+              : 0,
+          data_usage_flag)
+    , _p(degree)
+    , _knot_vector(knot_vector)
+    , _hodographs_are_up_to_date(GL_FALSE)
+    , _hodograph_data_revision(0)
+{
+    if (degree > maximum_degree ||
+        !_KnotVectorIsValid(knot_vector, _data.GetRowCount())) {
+        throw Exception("BSplineCurve3::BSplineCurve3 - Wrong degree or knot "
+                        "vector.");
+    }
+
+    SetDefinitionDomain(_knot_vector[_p], _knot_vector[_data.GetRowCount()]);
+}
+
+GLboolean
+BSplineCurve3::_KnotVectorIsValid(const ColumnMatrix<GLdouble> &knot_vector,
+                                  GLuint data_count) const
+{
+    if (data_count <= _p || knot_vector.GetRowCount() != data_count + _p + 1) {
+        return GL_FALSE;
+    }
+
+    for (GLuint i = 1; i < knot_vector.GetRowCount(); ++i) {
+        if (!(knot_vector[i - 1] <= knot_vector[i])) {
+            return GL_FALSE;
+        }
+    }
+
+    return knot_vector[_p] < knot_vector[data_count];
+}
+
+GLboolean
+BSplineCurve3::SetKnotVector(const ColumnMatrix<GLdouble> &knot_vector)
+{
+    GLuint n = _data.GetRowCount();
+
+    if (!_KnotVectorIsValid(knot_vector, n)) {
+        return GL_FALSE;
+    }
+
+    _knot_vector = knot_vector;
+
+    // the blending functions have changed
+    ++_data_revision;
+    _InvalidateImageBasis();
+
+    SetDefinitionDomain(_knot_vector[_p], _knot_vector[n]);
+
+    return GL_TRUE;
+}
+
+const ColumnMatrix<GLdouble> &BSplineCurve3::GetKnotVector() const
+{
+    return _knot_vector;
+}
+
+GLuint BSplineCurve3::GetDegree() const
+{
+    return _p;
+}
+
+GLuint BSplineCurve3::_FindSpan(GLdouble u) const
+{
+    const GLdouble *t = _knot_vector.GetColumnView(0).GetData();
+
+    return (GLuint)(upper_bound(t + _p + 1, t + _data.GetRowCount(), u) - t) -
+           1;
+}
+
+// the triangular scheme of the Cox-de Boor recursion, where
+// left[j] = u - t_{s+1-j} and right[j] = t_{s+j} - u
+GLvoid BSplineCurve3::_NonZeroBlendingFunctionValues(GLuint span, GLdouble u,
+                                                     GLdouble *values) const
+{
+    GLdouble left[maximum_degree + 1], right[maximum_degree + 1];
+
+    values[0] = 1.0;
+
+    for (GLuint j = 1; j <= _p; ++j) {
+        left[j]  = u - _knot_vector[span + 1 - j];
+        right[j] = _knot_vector[span + j] - u;
+
+        GLdouble saved = 0.0;
+
+        for (GLuint r = 0; r < j; ++r) {
+            GLdouble denominator = right[r + 1] + left[j - r];
+            GLdouble temp =
+                (denominator != 0.0) ? values[r] / denominator : 0.0;
+
+            values[r] = saved + right[r + 1] * temp;
+            saved     = left[j - r] * temp;
+        }
+
+        values[j] = saved;
+    }
+}
+
+// Algorithm A2.3 of L. Piegl, W. Tiller: The NURBS Book, 2nd ed., Springer,
+// 1997. The upper triangle of ndu stores the values of the blending functions
+// of every degree, while its lower triangle stores the knot differences of
+// the Cox-de Boor recursion, by which the coefficients a of the derivatives
+// are divided.
+GLvoid BSplineCurve3::_NonZeroBlendingFunctionDerivatives(
+    GLuint span, GLdouble u, GLuint max_order_of_derivatives,
+    GLdouble *derivatives) const
+{
+    GLdouble ndu[maximum_degree + 1][maximum_degree + 1];
+    GLdouble a[2][maximum_degree + 1];
+    GLdouble left[maximum_degree + 1], right[maximum_degree + 1];
+
+    GLint p = (GLint)_p;
+    GLint n = (GLint)max_order_of_derivatives;
+
+    ndu[0][0] = 1.0;
+
+    for (GLint j = 1; j <= p; ++j) {
+        left[j]  = u - _knot_vector[span + 1 - j];
+        right[j] = _knot_vector[span + j] - u;
+
+        GLdouble saved = 0.0;
+
+        for (GLint r = 0; r < j; ++r) {
+            ndu[j][r]     = right[r + 1] + left[j - r];
+            GLdouble temp = (ndu[j][r] != 0.0) ? ndu[r][j - 1] / ndu[j][r] : 0.0;
+
+            ndu[r][j] = saved + right[r + 1] * temp;
+            saved     = left[j - r] * temp;
+        }
+
+        ndu[j][j] = saved;
+    }
+
+    for (GLint j = 0; j <= p; ++j) {
+        derivatives[j] = ndu[j][p];
+    }
+
+    for (GLint r = 0; r <= p; ++r) {
+        GLint s1 = 0, s2 = 1;
+
+        a[0][0] = 1.0;
+
+        for (GLint k = 1; k <= n; ++k) {
+            GLdouble d  = 0.0;
+            GLint    rk = r - k, pk = p - k;
+
+            if (r >= k) {
+                a[s2][0] = (ndu[pk + 1][rk] != 0.0)
+                               ? a[s1][0] / ndu[pk + 1][rk]
+                               : 0.0;
+                d = a[s2][0] * ndu[rk][pk];
+            }
+
+            GLint j1 = (rk >= -1) ? 1 : -rk;
+            GLint j2 = (r - 1 <= pk) ? k - 1 : p - r;
+
+            for (GLint j = j1; j <= j2; ++j) {
+                a[s2][j] = (ndu[pk + 1][rk + j] != 0.0)
+                               ? (a[s1][j] - a[s1][j - 1]) / ndu[pk + 1][rk + j]
+                               : 0.0;
+                d += a[s2][j] * ndu[rk + j][pk];
+            }
+
+            if (r <= pk) {
+                a[s2][k] = (ndu[pk + 1][r] != 0.0)
+                               ? -a[s1][k - 1] / ndu[pk + 1][r]
+                               : 0.0;
+                d += a[s2][k] * ndu[r][pk];
+            }
+
+            derivatives[k * (p + 1) + r] = d;
+            swap(s1, s2);
+        }
+    }
+
+    // multiplication by the factors p! / (p - k)!
+    GLdouble factor = p;
+
+    for (GLint k = 1; k <= n; ++k) {
+        for (GLint j = 0; j <= p; ++j) {
+            derivatives[k * (p + 1) + j] *= factor;
+        }
+
+        factor *= p - k;
+    }
+}
+
+GLboolean
+BSplineCurve3::BlendingFunctionValues(GLdouble             u,
+                                      RowMatrix<GLdouble> &values) const
+{
+    GLuint n = _data.GetRowCount();
+
+    values.ResizeColumns(n);
+
+    for (GLuint i = 0; i < n; ++i) {
+        values[i] = 0.0;
+    }
+
+    GLuint   span = _FindSpan(u);
+    GLdouble non_zero_values[maximum_degree + 1];
+
+    _NonZeroBlendingFunctionValues(span, u, non_zero_values);
+
+    for (GLuint j = 0; j <= _p; ++j) {
+        values[span - _p + j] = non_zero_values[j];
+    }
+
+    return GL_TRUE;
+}
+
+GLboolean
+BSplineCurve3::BlendingFunctionDerivatives(GLuint   max_order_of_derivatives,
+                                           GLdouble u,
+                                           Matrix<GLdouble> &values) const
+{
+    GLuint n = _data.GetRowCount();
+
+    values.ResizeRows(max_order_of_derivatives + 1);
+    values.ResizeColumns(n);
+
+    for (GLuint r = 0; r <= max_order_of_derivatives; ++r) {
+        for (GLuint i = 0; i < n; ++i) {
+            values(r, i) = 0.0;
+        }
+    }
+
+    // the derivatives of order greater than p vanish
+    GLuint   span      = _FindSpan(u);
+    GLuint   max_order = min(max_order_of_derivatives, _p);
+    GLdouble derivatives[(maximum_degree + 1) * (maximum_degree + 1)];
+
+    _NonZeroBlendingFunctionDerivatives(span, u, max_order, derivatives);
+
+    for (GLuint r = 0; r <= max_order; ++r) {
+        for (GLuint j = 0; j <= _p; ++j) {
+            values(r, span - _p + j) = derivatives[r * (_p + 1) + j];
+        }
+    }
+
+    return GL_TRUE;
+}
+
+GLboolean
+BSplineCurve3::HasSameBlendingFunctionsAs(const LinearCombination3 &lc) const
+{
+    if (!LinearCombination3::HasSameBlendingFunctionsAs(lc)) {
+        return GL_FALSE;
+    }
+
+    // the types have been found to be equal
+    const BSplineCurve3 &curve = static_cast<const BSplineCurve3 &>(lc);
+
+    return _p == curve._p && _knot_vector == curve._knot_vector;
+}
+
+// The derivative of order r is a B-spline of degree p - r, its control points
+// are P^{(r)}_i = (p - r + 1) (P^{(r-1)}_{i+1} - P^{(r-1)}_i) /
+// (t_{i+p+1} - t_{i+r}), i = 0, 1, ..., n - r - 1, where P^{(0)}_i = d_i.
+GLvoid BSplineCurve3::_PrepareEvaluation() const
+{
+    if (_hodographs_are_up_to_date &&
+        _hodograph_data_revision == _data_revision) {
+        return;
+    }
+
+    GLuint n = _data.GetRowCount();
+
+    _hodograph_points.ResizeRows(_p + 1);
+    _hodograph_points.ResizeColumns(n);
+
+    for (GLuint i = 0; i < n; ++i) {
+        _hodograph_points(0, i) = _data[i];
+    }
+
+    for (GLuint r = 1; r <= _p; ++r) {
+        for (GLuint i = 0; i + r < n; ++i) {
+            GLdouble denominator =
+                _knot_vector[i + _p + 1] - _knot_vector[i + r];
+
+            if (denominator > 0.0) {
+                _hodograph_points(r, i) =
+                    (_p - r + 1) / denominator *
+                    (_hodograph_points(r - 1, i + 1) -
+                     _hodograph_points(r - 1, i));
+            } else {
+                _hodograph_points(r, i) = DCoordinate3();
+            }
+        }
+    }
+
+    _hodograph_data_revision   = _data_revision;
+    _hodographs_are_up_to_date = GL_TRUE;
+}
+
+GLvoid BSplineCurve3::_EvaluateDerivatives(GLuint max_order_of_derivatives,
+                                           GLdouble u, DCoordinate3 *d,
+                                           GLuint stride) const
+{
+    _EvaluateDerivativesInSpan(max_order_of_derivatives, _FindSpan(u), u, d,
+                               stride);
+}
+
+// de Boor's algorithm for the derivative of order r, i.e., for the degree
+// q = p - r, the knots t_r, ..., t_{n+p-r} and the span s - r
+GLvoid BSplineCurve3::_EvaluateDerivativesInSpan(
+    GLuint max_order_of_derivatives, GLuint span, GLdouble u, DCoordinate3 *d,
+    GLuint stride) const
+{
+    DCoordinate3 points[maximum_degree + 1];
+
+    for (GLuint r = 0; r <= max_order_of_derivatives; ++r) {
+        if (r > _p) {
+            d[r * stride] = DCoordinate3();
+            continue;
+        }
+
+        GLuint q = _p - r;
+
+        for (GLuint j = 0; j <= q; ++j) {
+            points[j] = _hodograph_points(r, span - _p + j);
+        }
+
+        for (GLuint l = 1; l <= q; ++l) {
+            for (GLuint j = q; j >= l; --j) {
+                GLdouble lower = _knot_vector[span - _p + r + j];
+                GLdouble upper = _knot_vector[span + 1 + j - l];
+                GLdouble alpha =
+                    (upper > lower) ? (u - lower) / (upper - lower) : 0.0;
+
+                points[j] = points[j - 1] * (1.0 - alpha) + points[j] * alpha;
+            }
+        }
+
+        d[r * stride] = points[q];
+    }
+}
+
+GLboolean BSplineCurve3::UpdateDataForInterpolation(
+    const ColumnMatrix<GLdouble> &    knot_vector,
+    const ColumnMatrix<DCoordinate3> &data_points_to_interpolate)
+{
+    GLuint n = _data.GetRowCount();
+
+    if (knot_vector.GetRowCount() != n ||
+        data_points_to_interpolate.GetRowCount() != n) {
+        return GL_FALSE;
+    }
+
+    if (!_interpolation_factorization ||
+        _interpolation_knot_vector != knot_vector) {
+        _interpolation_factorization.reset();
+
+        // row k of the collocation matrix has non-zero elements only in the
+        // columns s_k - p, ..., s_k, where s_k is the span of the knot u_k
+        vector<GLuint> spans(n);
+        GLuint         lower_bandwidth = 0, upper_bandwidth = 0;
+
+        for (GLuint k = 0; k < n; ++k) {
+            if (knot_vector[k] < _knot_vector[_p] ||
+                knot_vector[k] > _knot_vector[n]) {
+                return GL_FALSE;
+            }
+
+            spans[k] = _FindSpan(knot_vector[k]);
+
+            if (k + _p > spans[k]) {
+                lower_bandwidth = max(lower_bandwidth, k + _p - spans[k]);
+            }
+
+            if (spans[k] > k) {
+                upper_bandwidth = max(upper_bandwidth, spans[k] - k);
+            }
+        }
+
+        BandedSquareMatrix collocation_matrix(n, lower_bandwidth,
+                                              upper_bandwidth);
+        GLdouble           values[maximum_degree + 1];
+
+        for (GLuint k = 0; k < n; ++k) {
+            _NonZeroBlendingFunctionValues(spans[k], knot_vector[k], values);
+
+            for (GLuint j = 0; j <= _p; ++j) {
+                collocation_matrix(k, spans[k] - _p + j) = values[j];
+            }
+        }
+
+        // a null pointer, if the Schoenberg-Whitney conditions are violated
+        _interpolation_factorization = collocation_matrix.GetLUFactorization();
+
+        if (!_interpolation_factorization) {
+            return GL_FALSE;
+        }
+
+        _interpolation_knot_vector = knot_vector;
+    }
+
+    ++_data_revision;
+
+    return _interpolation_factorization->Solve(data_points_to_interpolate,
+                                               _data);
+}
+
+GenericCurve3 *BSplineCurve3::GenerateImage(GLuint max_order_of_derivatives,
+                                            GLuint div_point_count,
+                                            GLenum usage_flag) const
+{
+    if (!div_point_count) {
+        return nullptr;
+    }
+
+    _PrepareEvaluation();
+
+    Matrix<DCoordinate3> derivatives(max_order_of_derivatives + 1,
+                                     div_point_count);
+
+    // the column k of derivatives starts at element (0, k)
+    DCoordinate3 *column = &derivatives(0, 0);
+    GLuint        stride = div_point_count;
+
+    GLuint last_span = _data.GetRowCount() - 1;
+
+    // the image is split into ranges of consecutive points, which are
+    // evaluated by multiple threads; only the span of the first point of a
+    // range is searched for
+    const GLuint range_size  = 1024;
+    GLint        range_count = (GLint)((div_point_count + range_size - 1) /
+                                range_size);
+
+#pragma omp parallel for schedule(static) if (div_point_count >= _parallel_image_point_count)
+    for (GLint range = 0; range < range_count; ++range) {
+        GLuint begin = range * range_size;
+        GLuint end   = min(begin + range_size, div_point_count);
+        GLuint span =
+            _FindSpan(GetImageParameterValue(begin, div_point_count));
+
+        for (GLuint k = begin; k < end; ++k) {
+            GLdouble u = GetImageParameterValue(k, div_point_count);
+
+            while (span < last_span && u >= _knot_vector[span + 1]) {
+                ++span;
+            }
+
+            _EvaluateDerivativesInSpan(max_order_of_derivatives, span, u,
+                                       column + k, stride);
+        }
+    }
+
+    return new GenericCurve3(std::move(derivatives), usage_flag);
+}
+
+// the spans of the subdivision points do not decrease, thus the first point
+// of a span is found by a binary search
+GLuint BSplineCurve3::_FirstImagePointOfSpan(GLuint span,
+                                             GLuint div_point_count) const
+{
+    GLuint first = 0, last = div_point_count;
+
+    while (first < last) {
+        GLuint middle = first + (last - first) / 2;
+
+        if (_FindSpan(GetImageParameterValue(middle, div_point_count)) < span) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+
+    return first;
+}
+
+GLboolean BSplineCurve3::UpdateImageIncrementally(GLuint              index,
+                                                  const DCoordinate3 &delta,
+                                                  GenericCurve3 &     image)
+{
+    if (index >= _data.GetRowCount()) {
+        return GL_FALSE;
+    }
+
+    GLuint max_order_of_derivatives = image.GetMaximumOrderOfDerivatives();
+    GLuint div_point_count          = image.GetPointCount();
+
+    _MoveControlPoint(index, delta);
+
+    // N_{index,p} is non-zero only over the spans index, ..., index + p
+    GLuint first_index = _FirstImagePointOfSpan(index, div_point_count);
+    GLuint end_index = _FirstImagePointOfSpan(index + _p + 1, div_point_count);
+
+    if (first_index >= end_index) {
+        return GL_TRUE;
+    }
+
+    // the derivatives of order greater than p vanish
+    GLuint   max_order = min(max_order_of_derivatives, _p);
+    GLuint   last_span = _data.GetRowCount() - 1;
+    GLuint   span = _FindSpan(GetImageParameterValue(first_index, div_point_count));
+    GLdouble derivatives[(maximum_degree + 1) * (maximum_degree + 1)];
+
+    for (GLuint k = first_index; k < end_index; ++k) {
+        GLdouble u = GetImageParameterValue(k, div_point_count);
+
+        while (span < last_span && u >= _knot_vector[span + 1]) {
+            ++span;
+        }
+
+        _NonZeroBlendingFunctionDerivatives(span, u, max_order, derivatives);
+
+        // N_{index,p} is the (index + p - span)-th non-zero blending function
+        const GLdouble *weight = derivatives + index + _p - span;
+
+        for (GLuint r = 0; r <= max_order; ++r) {
+            image(r, k) += weight[r * (_p + 1)] * delta;
+        }
+    }
+
+    return _UpdateImageVertexBufferObjects(image, first_index, end_index - 1);
+}
+} // namespace cagd
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "../Core/LinearCombinationEngine3.h"
+#include "../Core/Matrices.h"
+
+namespace cagd {
+// B-spline curve of degree p with n control points and the knot vector
+// t_0 <= t_1 <= ... <= t_{n+p}, defined over [t_p, t_n]. Only the blending
+// functions N_{s-p,p}, ..., N_{s,p} are non-zero over the span
+// [t_s, t_{s+1}), thus the evaluation of a point costs O(p^2) operations
+// independently of n, and the collocation matrices are banded.
+class BSplineCurve3 : public LinearCombinationEngine3<BSplineCurve3>
+{
+    friend class LinearCombinationEngine3<BSplineCurve3>;
+
+public:
+    // the evaluation works on fixed size local arrays
+    static const GLuint maximum_degree = 25;
+
+protected:
+    GLuint                 _p;           // degree
+    ColumnMatrix<GLdouble> _knot_vector; // t_0, t_1, ..., t_{n+p}
+
+    // Control points of the derivatives: row r stores the n - r control
+    // points of the derivative of order r, which is a B-spline of degree
+    // p - r over the knots t_r, ..., t_{n+p-r}. They are recalculated only if
+    // the data revision changes, by _PrepareEvaluation, i.e., before the points
+    // of an image are evaluated in parallel, but not under any lock.
+    mutable GLboolean            _hodographs_are_up_to_date;
+    mutable GLuint               _hodograph_data_revision;
+    mutable Matrix<DCoordinate3> _hodograph_points;
+
+    // checks whether the knot vector is non-decreasing, of length n + p + 1,
+    // and whether its definition domain [t_p, t_n] is not degenerate
+    GLboolean _KnotVectorIsValid(const ColumnMatrix<GLdouble> &knot_vector,
+                                 GLuint data_count) const;
+
+    // index s of the span [t_s, t_{s+1}) that contains u, p <= s <= n - 1;
+    // values outside the definition domain are mapped to the first and the
+    // last spans, respectively
+    GLuint _FindSpan(GLdouble u) const;
+
+    // values of the p + 1 non-zero blending functions N_{s-p,p}, ..., N_{s,p}
+    // at u, which has to lie in the span s
+    GLvoid _NonZeroBlendingFunctionValues(GLuint span, GLdouble u,
+                                          GLdouble *values) const;
+
+    // derivatives of the p + 1 non-zero blending functions at u, which has to
+    // lie in the span s, i.e., derivatives[r * (p + 1) + j] stores
+    // N_{s-p+j,p}^{(r)}(u), where r = 0, 1, ..., max_order_of_derivatives <= p
+    GLvoid _NonZeroBlendingFunctionDerivatives(GLuint   span, GLdouble u,
+                                               GLuint   max_order_of_derivatives,
+                                               GLdouble *derivatives) const;
+
+    // index of the first subdivision point of an image of div_point_count
+    // points whose span is at least the given one
+    GLuint _FirstImagePointOfSpan(GLuint span, GLuint div_point_count) const;
+
+    // evaluation interface of LinearCombinationEngine3, the derivatives are
+    // evaluated by de Boor's algorithm applied to the hodographs
+    GLvoid _PrepareEvaluation() const;
+    GLvoid _EvaluateDerivatives(GLuint max_order_of_derivatives, GLdouble u,
+                                DCoordinate3 *d, GLuint stride) const;
+
+    // same as above, but u has to lie in the given span
+    GLvoid _EvaluateDerivativesInSpan(GLuint max_order_of_derivatives,
+                                      GLuint span, GLdouble u, DCoordinate3 *d,
+                                      GLuint stride) const;
+
+public:
+    // clamped uniform knot vector: t_0 = ... = t_p = u_min,
+    // t_n = ... = t_{n+p} = u_max, and the inner knots divide [u_min, u_max]
+    // into n - p equal spans
+    BSplineCurve3(GLuint degree, GLuint data_count, GLdouble u_min = 0.0,
+                  GLdouble u_max           = 1.0,
+                  GLenum   data_usage_flag = GL_STATIC_DRAW);
+
+    // arbitrary knot vector of length data_count + degree + 1
+    BSplineCurve3(GLuint degree, const ColumnMatrix<GLdouble> &knot_vector,
+                  GLenum data_usage_flag = GL_STATIC_DRAW);
+
+    // Replaces the knot vector, its length has to remain n + p + 1. The
+    // definition domain is reset to [t_p, t_n].
+    GLboolean SetKnotVector(const ColumnMatrix<GLdouble> &knot_vector);
+
+    const ColumnMatrix<GLdouble> &GetKnotVector() const;
+    GLuint                        GetDegree() const;
+
+    // Only the p + 1 blending functions of the span of u are evaluated, the
+    // other elements of the rows are set to zero.
+    GLboolean BlendingFunctionValues(GLdouble             u,
+                                     RowMatrix<GLdouble> &values) const;
+    GLboolean BlendingFunctionDerivatives(GLuint   max_order_of_derivatives,
+                                          GLdouble u,
+                                          Matrix<GLdouble> &values) const;
+
+    // B-splines of the same number of control points have the same blending
+    // functions only if their degrees and knot vectors agree as well
+    GLboolean
+    HasSameBlendingFunctionsAs(const LinearCombination3 &lc) const;
+
+    // Since N_{i,p} vanishes outside [t_i, t_{i+p+1}], only the subdivision
+    // points of the spans i, ..., i + p are updated, by the derivatives of
+    // N_{i,p} alone, and only their range of the vertex buffer objects is
+    // rewritten. The dense image basis of LinearCombination3 is not built.
+    GLboolean UpdateImageIncrementally(GLuint index, const DCoordinate3 &delta,
+                                       GenericCurve3 &image);
+
+    // the collocation matrix is assembled and factorized as a banded matrix,
+    // whose bandwidths are determined by the spans of the knots
+    GLboolean UpdateDataForInterpolation(
+        const ColumnMatrix<GLdouble> &    knot_vector,
+        const ColumnMatrix<DCoordinate3> &data_points_to_interpolate);
+
+    // samples the same uniform grid as LinearCombination3::GenerateImage, the
+    // span of the next subdivision point is found by advancing the span of
+    // the previous one instead of a search; ranges of consecutive points are
+    // evaluated by multiple threads
+    GenericCurve3 *GenerateImage(GLuint max_order_of_derivatives,
+                                 GLuint div_point_count,
+                                 GLenum usage_flag = GL_STATIC_DRAW) const;
+};
+} // namespace cagd
@@ -0,0 +1,396 @@
+#pragma once
+
+#include "DCoordinates3.h"
+#include "GenericCurves3.h"
+#include "Matrices.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace cagd {
+//-------------------------------------
+// template class AdaptiveCurveSampler3
+//-------------------------------------
+// Generates curve images whose points are distributed by a chord error
+// tolerance instead of uniformly. Starting from a coarse uniform grid, the
+// parameter interval of the largest estimated chord error is subdivided until
+// every chord deviates from the curve by at most the tolerance, or the
+// maximum point count is reached. Thus flat arcs are covered by a few long
+// chords, while tight loops get as many points as they need.
+//
+// The chord error of [u_l, u_r] is estimated by two quantities:
+// - the distance of the curve point at the midpoint from the chord;
+// - if first order derivatives are available, the largest distance of the
+//   cubic Hermite arc determined by the endpoints and their tangents from
+//   the chord, increased by the distance of the curve from the Hermite arc
+//   at the midpoint. This estimate reacts to curvature and inflections,
+//   which the midpoint alone may miss.
+//
+// Since the chord error decreases quadratically with the length of the
+// interval, an interval of estimated error e is split into
+// ceil(sqrt(e / chord_tolerance)) equal parts rather than halved, which would
+// overshoot the tolerance by a factor of up to 4.
+//
+// The evaluator has to provide the method
+//     GLboolean operator()(GLdouble u, DCoordinate3 *d) const;
+// which writes the derivatives of order 0, 1, ..., evaluated_order at u
+// into d[0], d[1], ..., d[evaluated_order].
+template <class Evaluator>
+class AdaptiveCurveSampler3
+{
+protected:
+    // a parameter interval given by the indices of its endpoints and of its
+    // midpoint in the sample arrays below
+    class Interval
+    {
+    public:
+        GLdouble error;
+        GLuint   left, middle, right;
+
+        GLboolean operator<(const Interval &rhs) const
+        {
+            return error < rhs.error;
+        }
+    };
+
+    const Evaluator &_evaluator;
+    GLuint           _evaluated_order;
+
+    // parameter values of the samples and their derivatives, the derivatives
+    // of sample k are stored by
+    // _derivatives[k * (_evaluated_order + 1) + r], r = 0, ..., evaluated_order
+    std::vector<GLdouble>     _u;
+    std::vector<DCoordinate3> _derivatives;
+    std::vector<GLboolean>    _is_vertex;
+
+    // evaluates and stores the sample at u
+    GLboolean _Sample(GLdouble u, GLboolean is_vertex, GLuint &index);
+
+    // estimates the largest distance of the arc over [_u[left], _u[right]]
+    // from its chord by the distances of the given inner samples and by the
+    // deviation of the Hermite arc
+    GLdouble _ChordError(GLuint left, GLuint right, const GLuint *inner,
+                         GLuint inner_count) const;
+
+    // evaluates the midpoint of [_u[left], _u[right]] and estimates the chord
+    // error of the interval
+    GLboolean _Estimate(GLuint left, GLuint right, Interval &interval);
+
+    // the component of v that is orthogonal to the unit vector direction
+    static DCoordinate3 _Orthogonal(const DCoordinate3 &v,
+                                    const DCoordinate3 &direction);
+
+public:
+    // special constructor
+    AdaptiveCurveSampler3(const Evaluator &evaluator, GLuint evaluated_order);
+
+    // Samples the arc over [u_min, u_max]. The image stores the derivatives
+    // up to max_order_of_derivatives <= evaluated_order at the selected
+    // parameter values in increasing order. At least initial_div_point_count
+    // (>= 2) uniform subdivision points are used, at most
+    // maximum_point_count points are emitted.
+    GenericCurve3 *GenerateImage(GLuint   max_order_of_derivatives,
+                                 GLdouble u_min, GLdouble u_max,
+                                 GLdouble chord_tolerance,
+                                 GLuint   initial_div_point_count,
+                                 GLuint   maximum_point_count,
+                                 GLenum   usage_flag = GL_STATIC_DRAW);
+};
+
+//-------------------------------------------------------
+// implementation of template class AdaptiveCurveSampler3
+//-------------------------------------------------------
+
+// special constructor
+template <class Evaluator>
+AdaptiveCurveSampler3<Evaluator>::AdaptiveCurveSampler3(
+    const Evaluator &evaluator, GLuint evaluated_order)
+    : _evaluator(evaluator)
+    , _evaluated_order(evaluated_order)
+{}
+
+template <class Evaluator>
+inline DCoordinate3
+AdaptiveCurveSampler3<Evaluator>::_Orthogonal(const DCoordinate3 &v,
+                                              const DCoordinate3 &direction)
+{
+    return v - direction * (v * direction);
+}
+
+template <class Evaluator>
+GLboolean AdaptiveCurveSampler3<Evaluator>::_Sample(GLdouble  u,
+                                                   GLboolean is_vertex,
+                                                   GLuint &  index)
+{
+    GLuint stride = _evaluated_order + 1;
+
+    index = (GLuint)_u.size();
+
+    _u.push_back(u);
+    _is_vertex.push_back(is_vertex);
+    _derivatives.resize(_derivatives.size() + stride);
+
+    if (!_evaluator(u, &_derivatives[index * stride]))
+        return GL_FALSE;
+
+    // rejects e.g. singular points of the parametrization
+    const DCoordinate3 &p = _derivatives[index * stride];
+
+    return std::isfinite(p[0]) && std::isfinite(p[1]) && std::isfinite(p[2]);
+}
+
+template <class Evaluator>
+GLdouble AdaptiveCurveSampler3<Evaluator>::_ChordError(GLuint        left,
+                                                      GLuint        right,
+                                                      const GLuint *inner,
+                                                      GLuint inner_count) const
+{
+    GLuint stride = _evaluated_order + 1;
+
+    const DCoordinate3 &p_l = _derivatives[left * stride];
+    const DCoordinate3 &p_r = _derivatives[right * stride];
+
+    DCoordinate3 chord        = p_r - p_l;
+    GLdouble     chord_length = chord.length();
+
+    DCoordinate3 direction;
+
+    if (chord_length > 0.0)
+        direction = chord / chord_length;
+
+    // distances of the inner samples from the chord (segment)
+    GLdouble error = 0.0;
+
+    for (GLuint i = 0; i < inner_count; ++i) {
+        DCoordinate3 v = _derivatives[inner[i] * stride] - p_l;
+        GLdouble     t = 0.0;
+
+        if (chord_length > 0.0)
+            t = std::min(std::max((v * direction) / chord_length, 0.0), 1.0);
+
+        error = std::max(error, (v - chord * t).length());
+    }
+
+    // deviation of the cubic Hermite arc from the chord, i.e., the length of
+    // h t (1 - t) ((1 - t) T_l^perp - t T_r^perp) at its possible maximum
+    // places t = 1/2 (convex arcs) and t = (3 -+ sqrt(3)) / 6 (inflections)
+    if (_evaluated_order >= 1) {
+        GLdouble h = _u[right] - _u[left];
+
+        DCoordinate3 a = _Orthogonal(_derivatives[left * stride + 1],
+                                     direction) * h;
+        DCoordinate3 b = _Orthogonal(_derivatives[right * stride + 1],
+                                     direction) * h;
+
+        const GLdouble t_inflection = 0.21132486540518713; // (3 - sqrt(3)) / 6
+        const GLdouble c_inflection = t_inflection * (1.0 - t_inflection);
+
+        error = std::max(error, ((a - b) * 0.125).length());
+        error = std::max(
+            error,
+            ((a * (1.0 - t_inflection) - b * t_inflection) * c_inflection)
+                .length());
+        error = std::max(
+            error,
+            ((a * t_inflection - b * (1.0 - t_inflection)) * c_inflection)
+                .length());
+    }
+
+    return error;
+}
+
+template <class Evaluator>
+GLboolean AdaptiveCurveSampler3<Evaluator>::_Estimate(GLuint    left,
+                                                     GLuint    right,
+                                                     Interval &interval)
+{
+    interval.left  = left;
+    interval.right = right;
+
+    if (!_Sample(0.5 * (_u[left] + _u[right]), GL_FALSE, interval.middle))
+        return GL_FALSE;
+
+    interval.error = _ChordError(left, right, &interval.middle, 1);
+
+    // the distance of the curve from the Hermite arc at the midpoint
+    if (_evaluated_order >= 1) {
+        GLuint   stride = _evaluated_order + 1;
+        GLdouble h      = _u[right] - _u[left];
+
+        DCoordinate3 hermite =
+            (_derivatives[left * stride] + _derivatives[right * stride]) *
+                0.5 +
+            (_derivatives[left * stride + 1] -
+             _derivatives[right * stride + 1]) *
+                (h / 8.0);
+
+        interval.error +=
+            (_derivatives[interval.middle * stride] - hermite).length();
+    }
+
+    return GL_TRUE;
+}
+
+template <class Evaluator>
+GenericCurve3 *AdaptiveCurveSampler3<Evaluator>::GenerateImage(
+    GLuint max_order_of_derivatives, GLdouble u_min, GLdouble u_max,
+    GLdouble chord_tolerance, GLuint initial_div_point_count,
+    GLuint maximum_point_count, GLenum usage_flag)
+{
+    if (max_order_of_derivatives > _evaluated_order ||
+        initial_div_point_count < 2 || !(chord_tolerance > 0.0) ||
+        !(u_min < u_max))
+        return nullptr;
+
+    maximum_point_count = std::max(maximum_point_count,
+                                   initial_div_point_count);
+
+    _u.clear();
+    _derivatives.clear();
+    _is_vertex.clear();
+
+    GLuint expected_sample_count = 2 * initial_div_point_count;
+
+    _u.reserve(expected_sample_count);
+    _is_vertex.reserve(expected_sample_count);
+    _derivatives.reserve(expected_sample_count * (_evaluated_order + 1));
+
+    // intervals shorter than this are not subdivided any more
+    GLdouble minimum_length = (u_max - u_min) * 1.0e-12;
+
+    // the initial uniform grid
+    GLdouble u_step = (u_max - u_min) / (initial_div_point_count - 1);
+    GLuint   index;
+
+    for (GLuint k = 0; k < initial_div_point_count; ++k) {
+        GLdouble u = (k < initial_div_point_count - 1) ? u_min + k * u_step
+                                                       : u_max;
+        if (!_Sample(u, GL_TRUE, index))
+            return nullptr;
+    }
+
+    std::priority_queue<Interval> intervals;
+    Interval                      interval;
+
+    for (GLuint k = 0; k < initial_div_point_count - 1; ++k) {
+        if (!_Estimate(k, k + 1, interval))
+            return nullptr;
+
+        if (interval.error > chord_tolerance)
+            intervals.push(interval);
+    }
+
+    // the interval of the largest error is subdivided first, thus the
+    // available points are spent on the worst chords if maximum_point_count
+    // is reached
+    GLuint point_count = initial_div_point_count;
+
+    std::vector<GLuint> parts;
+
+    while (!intervals.empty() && point_count < maximum_point_count) {
+        Interval worst = intervals.top();
+        intervals.pop();
+
+        GLdouble h = _u[worst.right] - _u[worst.left];
+
+        if (h < minimum_length)
+            continue;
+
+        GLuint part_count = (GLuint)std::min(
+            std::ceil(std::sqrt(worst.error / chord_tolerance)),
+            (GLdouble)(maximum_point_count - point_count + 1));
+
+        part_count = std::max(part_count, 2u);
+
+        // the endpoints of the parts, a halved interval reuses its midpoint
+        parts.resize(part_count + 1);
+        parts[0]          = worst.left;
+        parts[part_count] = worst.right;
+
+        if (part_count == 2) {
+            _is_vertex[worst.middle] = GL_TRUE;
+            parts[1]                 = worst.middle;
+        } else {
+            for (GLuint j = 1; j < part_count; ++j) {
+                if (!_Sample(_u[worst.left] + j * h / part_count, GL_TRUE,
+                             parts[j]))
+                    return nullptr;
+            }
+        }
+
+        point_count += part_count - 1;
+
+        for (GLuint j = 0; j < part_count; ++j) {
+            if (!_Estimate(parts[j], parts[j + 1], interval))
+                return nullptr;
+
+            if (interval.error > chord_tolerance)
+                intervals.push(interval);
+        }
+    }
+
+    // all samples in increasing order of their parameter values
+    std::vector<std::pair<GLdouble, GLuint>> samples;
+    samples.reserve(_u.size());
+
+    for (GLuint k = 0; k < (GLuint)_u.size(); ++k)
+        samples.push_back(std::make_pair(_u[k], k));
+
+    std::sort(samples.begin(), samples.end());
+
+    std::vector<GLuint> order(samples.size());
+
+    for (GLuint k = 0; k < (GLuint)samples.size(); ++k)
+        order[k] = samples[k].second;
+
+    // Subdivision leaves many chords well below the tolerance. A vertex is
+    // dropped if the chord that replaces it and its neighbouring chords
+    // still meets the tolerance w.r.t. every sample in between. At most
+    // maximum_merge_count chords are merged, so that the pass stays linear.
+    const GLuint maximum_merge_count = 4;
+
+    std::vector<GLuint> vertices;
+    vertices.reserve(point_count);
+
+    GLuint anchor = 0, pending = 0, merge_count = 0;
+
+    vertices.push_back(order[0]);
+
+    for (GLuint k = 1; k < (GLuint)order.size(); ++k) {
+        if (!_is_vertex[order[k]])
+            continue;
+
+        if (pending != anchor && merge_count < maximum_merge_count &&
+            _ChordError(order[anchor], order[k], &order[anchor + 1],
+                        k - anchor - 1) <= chord_tolerance) {
+            ++merge_count;
+        } else {
+            if (pending != anchor)
+                vertices.push_back(order[pending]);
+
+            anchor      = pending;
+            merge_count = 1;
+        }
+
+        pending = k;
+    }
+
+    vertices.push_back(order[pending]);
+
+    GLuint               stride = _evaluated_order + 1;
+    Matrix<DCoordinate3> derivatives(max_order_of_derivatives + 1,
+                                     (GLuint)vertices.size());
+
+    for (GLuint k = 0; k < (GLuint)vertices.size(); ++k) {
+        const DCoordinate3 *d = &_derivatives[vertices[k] * stride];
+
+        for (GLuint r = 0; r <= max_order_of_derivatives; ++r)
+            derivatives(r, k) = d[r];
+    }
+
+    return new GenericCurve3(std::move(derivatives), usage_flag);
+}
+} // namespace cagd
@@ -0,0 +1,264 @@
+#pragma once
+
+#include "DCoordinates3.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace cagd {
+//----------------------
+// class ArcLengthTable3
+//----------------------
+// Tabulates the arc length function s(u) = int_{u_min}^{u} |c'(t)| dt of a
+// curve c at the breakpoints of a uniform partition of its definition
+// domain. The integral over each segment is approximated by the 5-point
+// Gauss-Legendre rule (exact for polynomials of degree 9), thus the table
+// stores only the breakpoints and the cumulative lengths.
+//
+// Queries locate the segment by binary search in O(log segment_count), then
+// integrate from its left breakpoint (arc length at a parameter value), or
+// solve s(u) = s by Newton iterations safeguarded by bisection (parameter
+// value at an arc length).
+//
+// The table does not refer to the curve, the methods that need further
+// derivatives expect an evaluator with the method
+//     GLboolean operator()(GLdouble u, DCoordinate3 *d) const;
+// which writes the point and the first order derivative at u into d[0] and
+// d[1] (see also AdaptiveCurveSampler3).
+class ArcLengthTable3
+{
+protected:
+    // breakpoints u_j and arc lengths s_j = s(u_j), j = 0, ..., segment_count
+    std::vector<GLdouble> _u, _s;
+
+    // the speed |c'(u)|
+    template <class Evaluator>
+    static GLboolean _Speed(const Evaluator &evaluator, GLdouble u,
+                            GLdouble &speed);
+
+    // the arc length over [a, b] by the 5-point Gauss-Legendre rule
+    template <class Evaluator>
+    static GLboolean _Integrate(const Evaluator &evaluator, GLdouble a,
+                                GLdouble b, GLdouble &length);
+
+    // index j of the segment [u_j, u_{j+1}] that contains the given parameter
+    // value or arc length (values outside the table are clamped)
+    GLuint _FindSegment(const std::vector<GLdouble> &breakpoints,
+                        GLdouble                     value) const;
+
+public:
+    // tabulates the arc length over [u_min, u_max]
+    template <class Evaluator>
+    GLboolean Update(const Evaluator &evaluator, GLdouble u_min,
+                     GLdouble u_max, GLuint segment_count);
+
+    // arc length at the parameter value u of [u_min, u_max]
+    template <class Evaluator>
+    GLboolean ArcLengthAtParameter(const Evaluator &evaluator, GLdouble u,
+                                   GLdouble &s) const;
+
+    // parameter value that belongs to the arc length s of [0, GetLength()],
+    // GL_FALSE is returned if the iteration does not converge
+    template <class Evaluator>
+    GLboolean ParameterAtArcLength(const Evaluator &evaluator, GLdouble s,
+                                   GLdouble &u) const;
+
+    // get properties
+    GLdouble GetLength() const;
+    GLuint   GetSegmentCount() const;
+    GLvoid   GetDefinitionDomain(GLdouble &u_min, GLdouble &u_max) const;
+};
+
+//-----------------------------------------
+// implementation of class ArcLengthTable3
+//-----------------------------------------
+
+template <class Evaluator>
+inline GLboolean ArcLengthTable3::_Speed(const Evaluator &evaluator,
+                                         GLdouble u, GLdouble &speed)
+{
+    DCoordinate3 d[2];
+
+    if (!evaluator(u, d))
+        return GL_FALSE;
+
+    speed = d[1].length();
+
+    return std::isfinite(speed);
+}
+
+template <class Evaluator>
+GLboolean ArcLengthTable3::_Integrate(const Evaluator &evaluator, GLdouble a,
+                                      GLdouble b, GLdouble &length)
+{
+    // nodes and weights on [-1, 1]
+    static const GLdouble node[5]   = {0.0, -0.5384693101056831,
+                                     0.5384693101056831, -0.9061798459386640,
+                                     0.9061798459386640};
+    static const GLdouble weight[5] = {0.5688888888888889, 0.4786286704993665,
+                                       0.4786286704993665, 0.2369268850561891,
+                                       0.2369268850561891};
+
+    GLdouble half_length = 0.5 * (b - a), center = 0.5 * (a + b);
+
+    length = 0.0;
+
+    for (GLuint i = 0; i < 5; ++i) {
+        GLdouble speed;
+
+        if (!_Speed(evaluator, center + half_length * node[i], speed))
+            return GL_FALSE;
+
+        length += weight[i] * speed;
+    }
+
+    length *= half_length;
+
+    return GL_TRUE;
+}
+
+inline GLuint
+ArcLengthTable3::_FindSegment(const std::vector<GLdouble> &breakpoints,
+                              GLdouble                     value) const
+{
+    GLuint j = (GLuint)(std::upper_bound(breakpoints.begin(),
+                                         breakpoints.end(), value) -
+                        breakpoints.begin());
+
+    return std::min(std::max(j, 1u), (GLuint)breakpoints.size() - 1) - 1;
+}
+
+template <class Evaluator>
+GLboolean ArcLengthTable3::Update(const Evaluator &evaluator, GLdouble u_min,
+                                  GLdouble u_max, GLuint segment_count)
+{
+    if (!segment_count || !(u_min < u_max))
+        return GL_FALSE;
+
+    std::vector<GLdouble> u(segment_count + 1), s(segment_count + 1);
+
+    GLdouble u_step = (u_max - u_min) / segment_count;
+
+    u[0] = u_min;
+    s[0] = 0.0;
+
+    for (GLuint j = 1; j <= segment_count; ++j) {
+        u[j] = (j < segment_count) ? u_min + j * u_step : u_max;
+
+        GLdouble length;
+
+        if (!_Integrate(evaluator, u[j - 1], u[j], length))
+            return GL_FALSE;
+
+        s[j] = s[j - 1] + length;
+    }
+
+    _u.swap(u);
+    _s.swap(s);
+
+    return GL_TRUE;
+}
+
+template <class Evaluator>
+GLboolean ArcLengthTable3::ArcLengthAtParameter(const Evaluator &evaluator,
+                                                GLdouble u, GLdouble &s) const
+{
+    if (_u.empty() || u < _u.front() || u > _u.back())
+        return GL_FALSE;
+
+    GLuint j = _FindSegment(_u, u);
+
+    GLdouble length;
+
+    if (!_Integrate(evaluator, _u[j], u, length))
+        return GL_FALSE;
+
+    s = _s[j] + length;
+
+    return GL_TRUE;
+}
+
+template <class Evaluator>
+GLboolean ArcLengthTable3::ParameterAtArcLength(const Evaluator &evaluator,
+                                                GLdouble s, GLdouble &u) const
+{
+    if (_s.empty() || s < 0.0 || s > _s.back())
+        return GL_FALSE;
+
+    GLuint j = _FindSegment(_s, s);
+
+    GLdouble lower = _u[j], upper = _u[j + 1];
+    GLdouble segment_length = _s[j + 1] - _s[j];
+
+    // a segment of zero length is a single point
+    if (segment_length <= 0.0) {
+        u = lower;
+        return GL_TRUE;
+    }
+
+    // the arc length is nearly linear within a segment
+    u = lower + (upper - lower) * (s - _s[j]) / segment_length;
+
+    GLdouble tolerance = 1.0e-12 * std::max(_s.back(), 1.0);
+
+    for (GLuint iteration = 0; iteration < 64; ++iteration) {
+        GLdouble length, speed;
+
+        if (!_Integrate(evaluator, _u[j], u, length))
+            return GL_FALSE;
+
+        GLdouble f = _s[j] + length - s;
+
+        if (std::abs(f) <= tolerance)
+            return GL_TRUE;
+
+        if (f < 0.0)
+            lower = u;
+        else
+            upper = u;
+
+        if (!_Speed(evaluator, u, speed))
+            return GL_FALSE;
+
+        // Newton step, bisection if it leaves the bracket (e.g., at singular
+        // points, where the speed vanishes)
+        GLdouble next = (speed > 0.0) ? u - f / speed : lower;
+
+        if (!(next > lower && next < upper))
+            next = 0.5 * (lower + upper);
+
+        // the bracket cannot be narrowed any further in floating point
+        if (next == u)
+            return GL_TRUE;
+
+        u = next;
+    }
+
+    // the last iterate has not been checked yet
+    GLdouble length;
+
+    if (!_Integrate(evaluator, _u[j], u, length))
+        return GL_FALSE;
+
+    return std::abs(_s[j] + length - s) <= tolerance;
+}
+
+// get properties
+inline GLdouble ArcLengthTable3::GetLength() const
+{
+    return _s.empty() ? 0.0 : _s.back();
+}
+
+inline GLuint ArcLengthTable3::GetSegmentCount() const
+{
+    return _u.empty() ? 0 : (GLuint)_u.size() - 1;
+}
+
+inline GLvoid ArcLengthTable3::GetDefinitionDomain(GLdouble &u_min,
+                                                   GLdouble &u_max) const
+{
+    u_min = _u.empty() ? 0.0 : _u.front();
+    u_max = _u.empty() ? 0.0 : _u.back();
+}
+} // namespace cagd
@@ -0,0 +1,199 @@
+#include "BandedSquareMatrices.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace cagd;
+using namespace std;
+
+// special/default constructor
+BandedSquareMatrix::BandedSquareMatrix(GLuint size, GLuint lower_bandwidth,
+                                       GLuint upper_bandwidth)
+    : _size(size)
+    , _lower_bandwidth(lower_bandwidth)
+    , _upper_bandwidth(upper_bandwidth)
+    , _band_width(2 * lower_bandwidth + upper_bandwidth + 1)
+    , _data(size * _band_width, 0.0)
+    , _lu_decomposition_is_done(GL_FALSE)
+{}
+
+// copies the band of m, whose bandwidths are determined automatically
+BandedSquareMatrix::BandedSquareMatrix(const RealSquareMatrix &m)
+    : _size(m.GetRowCount())
+    , _lower_bandwidth(0)
+    , _upper_bandwidth(0)
+    , _lu_decomposition_is_done(GL_FALSE)
+{
+    DetermineBandwidths(m, _lower_bandwidth, _upper_bandwidth);
+
+    _band_width = 2 * _lower_bandwidth + _upper_bandwidth + 1;
+    _data.assign(_size * _band_width, 0.0);
+
+    for (GLuint i = 0; i < _size; ++i) {
+        GLuint first = i > _lower_bandwidth ? i - _lower_bandwidth : 0;
+        GLuint last  = min(i + _upper_bandwidth, _size - 1);
+
+        for (GLuint j = first; j <= last; ++j)
+            _data[i * _band_width + j + _lower_bandwidth - i] = m(i, j);
+    }
+}
+
+// determines the smallest bandwidths that contain every non-zero element of m
+GLvoid BandedSquareMatrix::DetermineBandwidths(const Matrix<GLdouble> &m,
+                                               GLuint &lower_bandwidth,
+                                               GLuint &upper_bandwidth)
+{
+    lower_bandwidth = upper_bandwidth = 0;
+
+    for (GLuint i = 0; i < m.GetRowCount(); ++i) {
+        // it suffices to scan the parts of the row outside of the current band
+        for (GLuint j = 0; j + lower_bandwidth < i; ++j)
+            if (m(i, j) != 0.0) {
+                lower_bandwidth = i - j;
+                break;
+            }
+
+        for (GLuint j = m.GetColumnCount(); j > i + upper_bandwidth + 1; --j)
+            if (m(i, j - 1) != 0.0) {
+                upper_bandwidth = j - 1 - i;
+                break;
+            }
+    }
+}
+
+// checks whether a banded decomposition is cheaper than a dense one
+GLboolean BandedSquareMatrix::IsProfitable(GLuint size, GLuint lower_bandwidth,
+                                           GLuint upper_bandwidth)
+{
+    return _profitable_band_ratio *
+               (2 * lower_bandwidth + upper_bandwidth + 1) <=
+           size;
+}
+
+// factorizes m as a banded or as a dense matrix
+shared_ptr<const LUFactorization>
+BandedSquareMatrix::FactorizeAutomatically(RealSquareMatrix &m)
+{
+    GLuint lower_bandwidth, upper_bandwidth;
+    DetermineBandwidths(m, lower_bandwidth, upper_bandwidth);
+
+    if (!IsProfitable(m.GetRowCount(), lower_bandwidth, upper_bandwidth))
+        return m.GetLUFactorization();
+
+    BandedSquareMatrix banded(m);
+
+    return banded.GetLUFactorization();
+}
+
+// get dimensions
+GLuint BandedSquareMatrix::GetSize() const { return _size; }
+
+GLuint BandedSquareMatrix::GetLowerBandwidth() const { return _lower_bandwidth; }
+
+GLuint BandedSquareMatrix::GetUpperBandwidth() const { return _upper_bandwidth; }
+
+// tries to determine the LU decomposition of this banded matrix
+GLboolean BandedSquareMatrix::PerformLUDecomposition()
+{
+    if (_lu_decomposition_is_done)
+        return GL_TRUE;
+
+    if (_size <= 1)
+        return GL_FALSE;
+
+    const GLdouble tiny = numeric_limits<GLdouble>::min();
+
+    const GLint size  = (GLint)_size;
+    const GLint lower = (GLint)_lower_bandwidth;
+    const GLint width = (GLint)_band_width;
+
+    // the element (i, j) of the band is stored at band[i * width + j - i]
+    GLdouble *band = _data.data() + lower;
+
+    vector<GLdouble> implicit_scaling_of_each_row(size);
+
+    _row_permutation.resize(size);
+
+    //-------------------------------------------------------
+    // loop over rows to get the implicit scaling information
+    //-------------------------------------------------------
+    for (GLint i = 0; i < size; ++i) {
+        const GLdouble *row = &_data[i * width];
+
+        GLdouble big = 0.0;
+        for (GLint j = 0; j < width; ++j) {
+            GLdouble temp = abs(row[j]);
+            if (temp > big)
+                big = temp;
+        }
+
+        if (big == 0.0) {
+            // the matrix is singular
+            return GL_FALSE;
+        }
+        implicit_scaling_of_each_row[i] = 1.0 / big;
+    }
+
+    //-------------------------------------------------------------------
+    // elimination with scaled partial pivoting restricted to the band:
+    // the pivot of column k is searched among the next lower_bandwidth
+    // rows, and the interchanged rows reach at most lower + upper
+    // bandwidth columns to the right of the diagonal
+    //-------------------------------------------------------------------
+    for (GLint k = 0; k < size; ++k) {
+        GLint last_row    = min(k + lower, size - 1);
+        GLint last_column = min(k + width - lower - 1, size - 1);
+
+        // search for the largest pivot element
+        GLint    imax = k;
+        GLdouble big  = 0.0;
+        for (GLint i = k; i <= last_row; ++i) {
+            GLdouble temp =
+                implicit_scaling_of_each_row[i] * abs(band[i * width + k - i]);
+            if (temp > big) {
+                big  = temp;
+                imax = i;
+            }
+        }
+
+        GLdouble *row_k = band + k * (width - 1);
+
+        // do we need to interchange rows? only the not yet eliminated columns
+        // are interchanged, the multipliers stay in place
+        if (k != imax) {
+            GLdouble *row_imax = band + imax * (width - 1);
+            for (GLint j = k; j <= last_column; ++j)
+                swap(row_k[j], row_imax[j]);
+            // also interchange the scale factor
+            implicit_scaling_of_each_row[imax] = implicit_scaling_of_each_row[k];
+        }
+
+        _row_permutation[k] = imax;
+        if (row_k[k] == 0.0)
+            row_k[k] = tiny;
+
+        // divide by pivot element and reduce the rows below
+        for (GLint i = k + 1; i <= last_row; ++i) {
+            GLdouble *row_i = band + i * (width - 1);
+            GLdouble  temp  = row_i[k] /= row_k[k];
+
+            for (GLint j = k + 1; j <= last_column; ++j)
+                row_i[j] -= temp * row_k[j];
+        }
+    }
+
+    _lu_decomposition_is_done = GL_TRUE;
+
+    return GL_TRUE;
+}
+
+shared_ptr<const LUFactorization> BandedSquareMatrix::GetLUFactorization()
+{
+    if (!PerformLUDecomposition())
+        return shared_ptr<const LUFactorization>();
+
+    return shared_ptr<const LUFactorization>(
+        new LUFactorization(_size, _lower_bandwidth, _upper_bandwidth, _data,
+                            _row_permutation));
+}
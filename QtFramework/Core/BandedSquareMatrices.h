@@ -0,0 +1,165 @@
+#pragma once
+
+#include "RealSquareMatrices.h"
+#include <GL/glew.h>
+#include <memory>
+#include <vector>
+
+namespace cagd {
+//-------------------------
+// class BandedSquareMatrix
+//-------------------------
+// A square matrix whose non-zero elements lie in the band
+// -lower_bandwidth <= column - row <= upper_bandwidth. Collocation matrices of
+// locally supported bases have this structure, and their LU decomposition and
+// the corresponding substitutions cost O(n * b^2) instead of O(n^3) operations,
+// where b is the bandwidth. Tridiagonal matrices are the special case of unit
+// lower and upper bandwidths.
+//
+// Storage: row i stores the columns
+// [i - lower_bandwidth, i + lower_bandwidth + upper_bandwidth] contiguously.
+// The extra lower_bandwidth columns on the right hold the fill-in caused by
+// partial pivoting.
+class BandedSquareMatrix
+{
+private:
+    GLuint                _size;
+    GLuint                _lower_bandwidth;
+    GLuint                _upper_bandwidth;
+    GLuint                _band_width; // 2 * lower + upper + 1
+    std::vector<GLdouble> _data;
+
+    GLboolean           _lu_decomposition_is_done;
+    std::vector<GLuint> _row_permutation;
+
+    // a banded decomposition pays off only if the stored band is at most
+    // this fraction of the rows, i.e., size >= 4 * (2 * lower + upper + 1)
+    static const GLuint _profitable_band_ratio = 4;
+
+public:
+    // special/default constructor, all elements are zero
+    BandedSquareMatrix(GLuint size = 1, GLuint lower_bandwidth = 0,
+                       GLuint upper_bandwidth = 0);
+
+    // copies the band of m, whose bandwidths are determined automatically
+    explicit BandedSquareMatrix(const RealSquareMatrix &m);
+
+    // determines the smallest bandwidths that contain every non-zero element
+    // of m
+    static GLvoid DetermineBandwidths(const Matrix<GLdouble> &m,
+                                      GLuint &lower_bandwidth,
+                                      GLuint &upper_bandwidth);
+
+    // checks whether a banded decomposition is cheaper than a dense one
+    static GLboolean IsProfitable(GLuint size, GLuint lower_bandwidth,
+                                  GLuint upper_bandwidth);
+
+    // Factorizes m as a banded matrix if its band structure pays off, and as a
+    // dense matrix otherwise. Interpolation routines use this method to solve
+    // their collocation systems. Returns a null pointer if m is singular.
+    static std::shared_ptr<const LUFactorization>
+    FactorizeAutomatically(RealSquareMatrix &m);
+
+    // get element by reference, (row, column) has to lie in the band
+    GLdouble &operator()(GLuint row, GLuint column);
+
+    // get copy of an element, elements outside of the band are zero
+    GLdouble operator()(GLuint row, GLuint column) const;
+
+    // get dimensions
+    GLuint GetSize() const;
+    GLuint GetLowerBandwidth() const;
+    GLuint GetUpperBandwidth() const;
+
+    // tries to determine the LU decomposition of this banded matrix
+    GLboolean PerformLUDecomposition();
+
+    // performs the LU decomposition if needed and returns an immutable copy of
+    // the factors that can outlive this matrix, or a null pointer if the
+    // matrix is singular
+    std::shared_ptr<const LUFactorization> GetLUFactorization();
+
+    // Solves linear systems of type A * x = b, see
+    // RealSquareMatrix::SolveLinearSystem for the meaning of the parameters.
+    template <class T>
+    GLboolean
+    SolveLinearSystem(const Matrix<T> &b, Matrix<T> &x,
+                      GLboolean represent_solutions_as_columns = GL_TRUE);
+
+    template <class U, class T>
+    GLboolean
+    SolveLinearSystem(const BlockView<U> &b, const BlockView<T> &x,
+                      GLboolean represent_solutions_as_columns = GL_TRUE);
+
+    template <class T>
+    GLboolean
+    SolveLinearSystem(const BlockView<T> &x,
+                      GLboolean represent_solutions_as_columns = GL_TRUE);
+};
+
+//-------------------------------------------------------------
+// implementation of the inline and template methods of class
+// BandedSquareMatrix
+//-------------------------------------------------------------
+inline GLdouble &BandedSquareMatrix::operator()(GLuint row, GLuint column)
+{
+    _lu_decomposition_is_done = GL_FALSE;
+    return _data[row * _band_width + column + _lower_bandwidth - row];
+}
+
+inline GLdouble BandedSquareMatrix::operator()(GLuint row, GLuint column) const
+{
+    if (column + _lower_bandwidth < row || column > row + _upper_bandwidth)
+        return 0.0;
+
+    return _data[row * _band_width + column + _lower_bandwidth - row];
+}
+
+template <class T>
+GLboolean
+BandedSquareMatrix::SolveLinearSystem(const Matrix<T> &b, Matrix<T> &x,
+                                      GLboolean represent_solutions_as_columns)
+{
+    if (represent_solutions_as_columns) {
+        if (b.GetRowCount() != _size)
+            return GL_FALSE;
+    } else {
+        if (b.GetColumnCount() != _size)
+            return GL_FALSE;
+    }
+
+    x = b;
+
+    return SolveLinearSystem(x.GetBlockView(), represent_solutions_as_columns);
+}
+
+template <class U, class T>
+GLboolean
+BandedSquareMatrix::SolveLinearSystem(const BlockView<U> &b,
+                                      const BlockView<T> &x,
+                                      GLboolean represent_solutions_as_columns)
+{
+    if (b.GetRowCount() != x.GetRowCount() ||
+        b.GetColumnCount() != x.GetColumnCount())
+        return GL_FALSE;
+
+    LUFactorization::_CopyRightHandSides(b, x);
+
+    return SolveLinearSystem(x, represent_solutions_as_columns);
+}
+
+template <class T>
+GLboolean
+BandedSquareMatrix::SolveLinearSystem(const BlockView<T> &x,
+                                      GLboolean represent_solutions_as_columns)
+{
+    if (!_lu_decomposition_is_done)
+        if (!PerformLUDecomposition())
+            return GL_FALSE;
+
+    return LUFactorization::_SubstituteBandedInPlace(
+        (GLint)_size, (GLint)_lower_bandwidth, (GLint)_upper_bandwidth,
+        _data.data(), _row_permutation.data(), x,
+        represent_solutions_as_columns);
+}
+} // namespace cagd
@@ -0,0 +1,526 @@
+#pragma once
+
+#include "DCoordinates3.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace cagd {
+//------------------------
+// class TCoordinateArray3
+//------------------------
+// An array of three dimensional coordinates in structure of arrays layout:
+// the x, y and z components are stored by three separate contiguous arrays.
+// This layout is processed by the batch kernels below, which apply the same
+// operation to every element, several elements at a time.
+template <class T>
+class TCoordinateArray3
+{
+protected:
+    std::vector<T> _x, _y, _z;
+
+public:
+    // special/default constructor, all coordinates are null vectors
+    TCoordinateArray3(GLuint size = 0);
+
+    // gathers the components of an array of coordinates
+    template <class U>
+    TCoordinateArray3(const TCoordinate3<U> *coordinates, GLuint size);
+
+    // get/set coordinates by value
+    TCoordinate3<T> operator[](GLuint index) const;
+    GLvoid          Set(GLuint index, const TCoordinate3<T> &c);
+
+    // pointers to the component arrays
+    T *      X();
+    T *      Y();
+    T *      Z();
+    const T *X() const;
+    const T *Y() const;
+    const T *Z() const;
+
+    GLuint    GetSize() const;
+    GLboolean Resize(GLuint size);
+
+    // scatters the components into an array of coordinates, possibly of
+    // another scalar type
+    template <class U>
+    GLvoid Scatter(TCoordinate3<U> *coordinates) const;
+};
+
+typedef TCoordinateArray3<GLdouble> DCoordinateArray3;
+typedef TCoordinateArray3<GLfloat>  FCoordinateArray3;
+
+//---------------------------------------------------------------------
+// Batch kernels. Their backends are selected at compile time: if AVX is
+// enabled, the element loops process 4 doubles or 8 floats at a time by
+// intrinsics, otherwise they are plain loops over contiguous arrays that
+// the compiler may vectorize. Arrays longer than
+// batch_kernel_parallel_threshold are split into chunks that are
+// processed by multiple threads (OpenMP).
+//---------------------------------------------------------------------
+const GLuint batch_kernel_chunk_size         = 4096;
+const GLuint batch_kernel_parallel_threshold = 4 * batch_kernel_chunk_size;
+
+// normalizes every coordinate, null vectors are left unchanged
+template <class T>
+GLvoid NormalizeAll(TCoordinateArray3<T> &a);
+
+// result[i] = a[i] x b[i], result may coincide with a or b
+template <class T>
+GLboolean CrossAll(const TCoordinateArray3<T> &a, const TCoordinateArray3<T> &b,
+                   TCoordinateArray3<T> &result);
+
+// y[i] += s * x[i]
+template <class T>
+GLboolean AxpyAll(T s, const TCoordinateArray3<T> &x, TCoordinateArray3<T> &y);
+
+// y[i] += s * x[i] for flat arrays of count scalars, e.g., for mapped vertex
+// buffer objects of interleaved coordinates
+template <class T>
+GLvoid AxpyAll(GLuint count, T s, const T *x, T *y);
+
+// determines the corners of the axis aligned bounding box
+template <class T>
+GLboolean GetBoundingBox(const TCoordinateArray3<T> &a,
+                         TCoordinate3<T> &leftmost, TCoordinate3<T> &rightmost);
+
+// converts the components of the flat array source into the scalar type of
+// destination
+template <class T, class U>
+GLvoid ConvertAll(GLuint count, const T *source, U *destination);
+
+//-------------------------------------------------------------
+// SIMD packs of the AVX backend: a uniform interface to the
+// 256-bit registers of floats and doubles
+//-------------------------------------------------------------
+#if defined(__AVX__)
+template <class T>
+struct SimdPack
+{
+    static const GLuint width = 1; // no pack for other scalar types
+};
+
+template <>
+struct SimdPack<GLfloat>
+{
+    typedef __m256      Type;
+    static const GLuint width = 8;
+
+    static Type Load(const GLfloat *p) { return _mm256_loadu_ps(p); }
+    static void Store(GLfloat *p, Type v) { _mm256_storeu_ps(p, v); }
+    static Type Set(GLfloat s) { return _mm256_set1_ps(s); }
+    static Type Add(Type a, Type b) { return _mm256_add_ps(a, b); }
+    static Type Sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+    static Type Mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+    static Type Div(Type a, Type b) { return _mm256_div_ps(a, b); }
+    static Type Sqrt(Type a) { return _mm256_sqrt_ps(a); }
+    static Type Min(Type a, Type b) { return _mm256_min_ps(a, b); }
+    static Type Max(Type a, Type b) { return _mm256_max_ps(a, b); }
+    // s where a == 0, a otherwise
+    static Type ReplaceZero(Type a, Type s)
+    {
+        return _mm256_blendv_ps(a, s, _mm256_cmp_ps(a, Set(0), _CMP_EQ_OQ));
+    }
+};
+
+template <>
+struct SimdPack<GLdouble>
+{
+    typedef __m256d     Type;
+    static const GLuint width = 4;
+
+    static Type Load(const GLdouble *p) { return _mm256_loadu_pd(p); }
+    static void Store(GLdouble *p, Type v) { _mm256_storeu_pd(p, v); }
+    static Type Set(GLdouble s) { return _mm256_set1_pd(s); }
+    static Type Add(Type a, Type b) { return _mm256_add_pd(a, b); }
+    static Type Sub(Type a, Type b) { return _mm256_sub_pd(a, b); }
+    static Type Mul(Type a, Type b) { return _mm256_mul_pd(a, b); }
+    static Type Div(Type a, Type b) { return _mm256_div_pd(a, b); }
+    static Type Sqrt(Type a) { return _mm256_sqrt_pd(a); }
+    static Type Min(Type a, Type b) { return _mm256_min_pd(a, b); }
+    static Type Max(Type a, Type b) { return _mm256_max_pd(a, b); }
+    // s where a == 0, a otherwise
+    static Type ReplaceZero(Type a, Type s)
+    {
+        return _mm256_blendv_pd(a, s, _mm256_cmp_pd(a, Set(0), _CMP_EQ_OQ));
+    }
+};
+#endif
+
+//-----------------------------------------------------------
+// element range kernels, i.e., the serial building blocks of
+// the batch kernels
+//-----------------------------------------------------------
+namespace batch_kernels {
+template <class T>
+inline GLvoid NormalizeRange(GLuint begin, GLuint end, T *x, T *y, T *z)
+{
+    GLuint i = begin;
+
+#if defined(__AVX__)
+    typedef SimdPack<T> P;
+    for (; i + P::width <= end; i += P::width) {
+        typename P::Type vx = P::Load(x + i), vy = P::Load(y + i),
+                         vz = P::Load(z + i);
+        typename P::Type l  = P::Sqrt(P::Add(
+            P::Add(P::Mul(vx, vx), P::Mul(vy, vy)), P::Mul(vz, vz)));
+        l                   = P::ReplaceZero(l, P::Set(1));
+
+        P::Store(x + i, P::Div(vx, l));
+        P::Store(y + i, P::Div(vy, l));
+        P::Store(z + i, P::Div(vz, l));
+    }
+#endif
+
+    for (; i < end; ++i) {
+        T l = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+        if (l == 0)
+            l = 1;
+
+        x[i] /= l;
+        y[i] /= l;
+        z[i] /= l;
+    }
+}
+
+template <class T>
+inline GLvoid CrossRange(GLuint begin, GLuint end, const T *ax, const T *ay,
+                         const T *az, const T *bx, const T *by, const T *bz,
+                         T *rx, T *ry, T *rz)
+{
+    GLuint i = begin;
+
+#if defined(__AVX__)
+    typedef SimdPack<T> P;
+    for (; i + P::width <= end; i += P::width) {
+        typename P::Type vax = P::Load(ax + i), vay = P::Load(ay + i),
+                         vaz = P::Load(az + i);
+        typename P::Type vbx = P::Load(bx + i), vby = P::Load(by + i),
+                         vbz = P::Load(bz + i);
+
+        P::Store(rx + i, P::Sub(P::Mul(vay, vbz), P::Mul(vaz, vby)));
+        P::Store(ry + i, P::Sub(P::Mul(vaz, vbx), P::Mul(vax, vbz)));
+        P::Store(rz + i, P::Sub(P::Mul(vax, vby), P::Mul(vay, vbx)));
+    }
+#endif
+
+    for (; i < end; ++i) {
+        T xval = ay[i] * bz[i] - az[i] * by[i];
+        T yval = az[i] * bx[i] - ax[i] * bz[i];
+        T zval = ax[i] * by[i] - ay[i] * bx[i];
+        rx[i]  = xval;
+        ry[i]  = yval;
+        rz[i]  = zval;
+    }
+}
+
+template <class T>
+inline GLvoid AxpyRange(GLuint begin, GLuint end, T s, const T *x, T *y)
+{
+    GLuint i = begin;
+
+#if defined(__AVX__)
+    typedef SimdPack<T> P;
+    typename P::Type    vs = P::Set(s);
+    for (; i + P::width <= end; i += P::width)
+        P::Store(y + i, P::Add(P::Load(y + i), P::Mul(vs, P::Load(x + i))));
+#endif
+
+    for (; i < end; ++i)
+        y[i] += s * x[i];
+}
+
+template <class T>
+inline GLvoid MinMaxRange(GLuint begin, GLuint end, const T *x, T &minimum,
+                          T &maximum)
+{
+    GLuint i = begin;
+
+#if defined(__AVX__)
+    typedef SimdPack<T> P;
+    if (i + P::width <= end) {
+        typename P::Type vmin = P::Load(x + i), vmax = vmin;
+        for (i += P::width; i + P::width <= end; i += P::width) {
+            typename P::Type v = P::Load(x + i);
+            vmin               = P::Min(vmin, v);
+            vmax               = P::Max(vmax, v);
+        }
+
+        T lanes[P::width];
+        P::Store(lanes, vmin);
+        for (GLuint k = 0; k < P::width; ++k)
+            minimum = std::min(minimum, lanes[k]);
+        P::Store(lanes, vmax);
+        for (GLuint k = 0; k < P::width; ++k)
+            maximum = std::max(maximum, lanes[k]);
+    }
+#endif
+
+    for (; i < end; ++i) {
+        minimum = std::min(minimum, x[i]);
+        maximum = std::max(maximum, x[i]);
+    }
+}
+
+// number of chunks of the range [0, count)
+inline GLint ChunkCount(GLuint count)
+{
+    return (GLint)((count + batch_kernel_chunk_size - 1) /
+                   batch_kernel_chunk_size);
+}
+} // namespace batch_kernels
+
+//--------------------------------------------------------------------
+// the AVX loops above are instantiated only for the scalar types that
+// have SIMD packs
+//--------------------------------------------------------------------
+#if defined(__AVX__)
+#define CAGD_BATCH_KERNELS_CHECK_PACK(T)                                       \
+    static_assert(SimdPack<T>::width > 1,                                      \
+                  "batch kernels support GLfloat and GLdouble only")
+#else
+#define CAGD_BATCH_KERNELS_CHECK_PACK(T)
+#endif
+
+//---------------------------------------------
+// implementation of class TCoordinateArray3<T>
+//---------------------------------------------
+template <class T>
+TCoordinateArray3<T>::TCoordinateArray3(GLuint size)
+    : _x(size, 0)
+    , _y(size, 0)
+    , _z(size, 0)
+{}
+
+template <class T>
+template <class U>
+TCoordinateArray3<T>::TCoordinateArray3(const TCoordinate3<U> *coordinates,
+                                        GLuint                 size)
+    : _x(size)
+    , _y(size)
+    , _z(size)
+{
+    for (GLuint i = 0; i < size; ++i) {
+        _x[i] = (T)coordinates[i][0];
+        _y[i] = (T)coordinates[i][1];
+        _z[i] = (T)coordinates[i][2];
+    }
+}
+
+template <class T>
+inline TCoordinate3<T> TCoordinateArray3<T>::operator[](GLuint index) const
+{
+    return TCoordinate3<T>(_x[index], _y[index], _z[index]);
+}
+
+template <class T>
+inline GLvoid TCoordinateArray3<T>::Set(GLuint index, const TCoordinate3<T> &c)
+{
+    _x[index] = c[0];
+    _y[index] = c[1];
+    _z[index] = c[2];
+}
+
+template <class T>
+inline T *TCoordinateArray3<T>::X()
+{
+    return _x.data();
+}
+
+template <class T>
+inline T *TCoordinateArray3<T>::Y()
+{
+    return _y.data();
+}
+
+template <class T>
+inline T *TCoordinateArray3<T>::Z()
+{
+    return _z.data();
+}
+
+template <class T>
+inline const T *TCoordinateArray3<T>::X() const
+{
+    return _x.data();
+}
+
+template <class T>
+inline const T *TCoordinateArray3<T>::Y() const
+{
+    return _y.data();
+}
+
+template <class T>
+inline const T *TCoordinateArray3<T>::Z() const
+{
+    return _z.data();
+}
+
+template <class T>
+inline GLuint TCoordinateArray3<T>::GetSize() const
+{
+    return (GLuint)_x.size();
+}
+
+template <class T>
+GLboolean TCoordinateArray3<T>::Resize(GLuint size)
+{
+    _x.resize(size, 0);
+    _y.resize(size, 0);
+    _z.resize(size, 0);
+
+    return GL_TRUE;
+}
+
+template <class T>
+template <class U>
+GLvoid TCoordinateArray3<T>::Scatter(TCoordinate3<U> *coordinates) const
+{
+    GLint size = (GLint)_x.size();
+
+#pragma omp parallel for schedule(static) if (size >= (GLint)batch_kernel_parallel_threshold)
+    for (GLint i = 0; i < size; ++i)
+        coordinates[i] = TCoordinate3<U>((U)_x[i], (U)_y[i], (U)_z[i]);
+}
+
+//-------------------------------------
+// implementation of the batch kernels
+//-------------------------------------
+template <class T>
+GLvoid NormalizeAll(TCoordinateArray3<T> &a)
+{
+    CAGD_BATCH_KERNELS_CHECK_PACK(T);
+
+    GLuint size        = a.GetSize();
+    GLint  chunk_count = batch_kernels::ChunkCount(size);
+
+#pragma omp parallel for schedule(static) if (size >= batch_kernel_parallel_threshold)
+    for (GLint c = 0; c < chunk_count; ++c) {
+        GLuint begin = c * batch_kernel_chunk_size;
+        GLuint end   = std::min(begin + batch_kernel_chunk_size, size);
+
+        batch_kernels::NormalizeRange(begin, end, a.X(), a.Y(), a.Z());
+    }
+}
+
+template <class T>
+GLboolean CrossAll(const TCoordinateArray3<T> &a, const TCoordinateArray3<T> &b,
+                   TCoordinateArray3<T> &result)
+{
+    CAGD_BATCH_KERNELS_CHECK_PACK(T);
+
+    GLuint size = a.GetSize();
+
+    if (b.GetSize() != size)
+        return GL_FALSE;
+
+    if (result.GetSize() != size)
+        result.Resize(size);
+
+    GLint chunk_count = batch_kernels::ChunkCount(size);
+
+#pragma omp parallel for schedule(static) if (size >= batch_kernel_parallel_threshold)
+    for (GLint c = 0; c < chunk_count; ++c) {
+        GLuint begin = c * batch_kernel_chunk_size;
+        GLuint end   = std::min(begin + batch_kernel_chunk_size, size);
+
+        batch_kernels::CrossRange(begin, end, a.X(), a.Y(), a.Z(), b.X(),
+                                  b.Y(), b.Z(), result.X(), result.Y(),
+                                  result.Z());
+    }
+
+    return GL_TRUE;
+}
+
+template <class T>
+GLboolean AxpyAll(T s, const TCoordinateArray3<T> &x, TCoordinateArray3<T> &y)
+{
+    if (x.GetSize() != y.GetSize())
+        return GL_FALSE;
+
+    AxpyAll(x.GetSize(), s, x.X(), y.X());
+    AxpyAll(x.GetSize(), s, x.Y(), y.Y());
+    AxpyAll(x.GetSize(), s, x.Z(), y.Z());
+
+    return GL_TRUE;
+}
+
+template <class T>
+GLvoid AxpyAll(GLuint count, T s, const T *x, T *y)
+{
+    CAGD_BATCH_KERNELS_CHECK_PACK(T);
+
+    GLint chunk_count = batch_kernels::ChunkCount(count);
+
+#pragma omp parallel for schedule(static) if (count >= batch_kernel_parallel_threshold)
+    for (GLint c = 0; c < chunk_count; ++c) {
+        GLuint begin = c * batch_kernel_chunk_size;
+        GLuint end   = std::min(begin + batch_kernel_chunk_size, count);
+
+        batch_kernels::AxpyRange(begin, end, s, x, y);
+    }
+}
+
+template <class T>
+GLboolean GetBoundingBox(const TCoordinateArray3<T> &a,
+                         TCoordinate3<T> &leftmost, TCoordinate3<T> &rightmost)
+{
+    CAGD_BATCH_KERNELS_CHECK_PACK(T);
+
+    GLuint size = a.GetSize();
+
+    if (!size)
+        return GL_FALSE;
+
+    // partial bounding boxes of the chunks, merged serially, since OpenMP 2.0
+    // (MSVC) has no min/max reductions
+    GLint        chunk_count = batch_kernels::ChunkCount(size);
+    std::vector<T> partial(6 * chunk_count);
+
+#pragma omp parallel for schedule(static) if (size >= batch_kernel_parallel_threshold)
+    for (GLint c = 0; c < chunk_count; ++c) {
+        GLuint begin = c * batch_kernel_chunk_size;
+        GLuint end   = std::min(begin + batch_kernel_chunk_size, size);
+        T *    box   = &partial[6 * c];
+
+        const T *component[3] = {a.X(), a.Y(), a.Z()};
+        for (GLuint k = 0; k < 3; ++k) {
+            box[k]     = std::numeric_limits<T>::max();
+            box[k + 3] = -std::numeric_limits<T>::max();
+            batch_kernels::MinMaxRange(begin, end, component[k], box[k],
+                                       box[k + 3]);
+        }
+    }
+
+    for (GLuint k = 0; k < 3; ++k) {
+        leftmost[k]  = partial[k];
+        rightmost[k] = partial[k + 3];
+    }
+
+    for (GLint c = 1; c < chunk_count; ++c)
+        for (GLuint k = 0; k < 3; ++k) {
+            leftmost[k]  = std::min(leftmost[k], partial[6 * c + k]);
+            rightmost[k] = std::max(rightmost[k], partial[6 * c + k + 3]);
+        }
+
+    return GL_TRUE;
+}
+
+template <class T, class U>
+GLvoid ConvertAll(GLuint count, const T *source, U *destination)
+{
+    GLint size = (GLint)count;
+
+#pragma omp parallel for schedule(static) if (size >= (GLint)batch_kernel_parallel_threshold)
+    for (GLint i = 0; i < size; ++i)
+        destination[i] = (U)source[i];
+}
+} // namespace cagd
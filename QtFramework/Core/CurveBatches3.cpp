@@ -0,0 +1,478 @@
+#include "CurveBatches3.h"
+#include "Exceptions.h"
+#include <algorithm>
+
+using namespace cagd;
+using namespace std;
+
+//------------------------------------
+// implementation of class CurveBatch3
+//------------------------------------
+
+// special constructor
+CurveBatch3::CurveBatch3(const LinearCombination3 &prototype,
+                         GLuint max_order_of_derivatives,
+                         GLuint div_point_count, GLenum usage_flag)
+    : _usage_flag(usage_flag)
+    , _vbo_vertices(0)
+    , _data_count(prototype.GetDataCount())
+    , _max_order_of_derivatives(max_order_of_derivatives)
+    , _div_point_count(div_point_count)
+    , _vbo_curve_count(0)
+{
+    if (!_data_count || !div_point_count)
+        throw Exception("CurveBatch3::CurveBatch3 - Empty prototype or "
+                        "image.");
+
+    // only the blending functions of the copy are needed
+    LinearCombination3 *copy = prototype.Clone();
+    copy->DeleteVertexBufferObjectsOfData();
+    _prototype.reset(copy);
+
+    _basis.ResizeRows((max_order_of_derivatives + 1) * div_point_count);
+    _basis.ResizeColumns(_data_count);
+
+    _data.resize(_data_count);
+
+    RowMatrix<GLdouble> values;
+    Matrix<GLdouble>    derivatives;
+
+    // the same subdivision points as the ones of GenerateImage
+    for (GLuint k = 0; k < div_point_count; ++k) {
+        GLdouble u = prototype.GetImageParameterValue(k, div_point_count);
+
+        if (prototype.BlendingFunctionDerivatives(max_order_of_derivatives, u,
+                                                  derivatives)) {
+            for (GLuint r = 0; r <= max_order_of_derivatives; ++r)
+                for (GLuint i = 0; i < _data_count; ++i)
+                    _basis(r * div_point_count + k, i) = derivatives(r, i);
+        } else if (!max_order_of_derivatives &&
+                   prototype.BlendingFunctionValues(u, values)) {
+            for (GLuint i = 0; i < _data_count; ++i)
+                _basis(k, i) = values[i];
+        } else {
+            throw Exception("CurveBatch3::CurveBatch3 - The derivatives of "
+                            "the blending functions are not available.");
+        }
+    }
+}
+
+// copy constructor
+CurveBatch3::CurveBatch3(const CurveBatch3 &batch)
+    : _usage_flag(batch._usage_flag)
+    , _vbo_vertices(0)
+    , _prototype(batch._prototype)
+    , _data_count(batch._data_count)
+    , _max_order_of_derivatives(batch._max_order_of_derivatives)
+    , _div_point_count(batch._div_point_count)
+    , _basis(batch._basis)
+    , _data(batch._data)
+    , _vertex(batch._vertex)
+    , _vbo_curve_count(0)
+{
+    if (batch._vbo_vertices)
+        UpdateVertexBufferObject(_usage_flag);
+}
+
+// move constructor
+CurveBatch3::CurveBatch3(CurveBatch3 &&batch) noexcept
+    : _usage_flag(batch._usage_flag)
+    , _vbo_vertices(batch._vbo_vertices)
+    , _prototype(batch._prototype)
+    , _data_count(batch._data_count)
+    , _max_order_of_derivatives(batch._max_order_of_derivatives)
+    , _div_point_count(batch._div_point_count)
+    , _basis(std::move(batch._basis))
+    , _data(std::move(batch._data))
+    , _vertex(std::move(batch._vertex))
+    , _vbo_curve_count(batch._vbo_curve_count)
+{
+    batch._vbo_vertices    = 0;
+    batch._vbo_curve_count = 0;
+}
+
+// assignment operator
+CurveBatch3 &CurveBatch3::operator=(const CurveBatch3 &rhs)
+{
+    if (this != &rhs) {
+        DeleteVertexBufferObject();
+
+        _usage_flag               = rhs._usage_flag;
+        _prototype                = rhs._prototype;
+        _data_count               = rhs._data_count;
+        _max_order_of_derivatives = rhs._max_order_of_derivatives;
+        _div_point_count          = rhs._div_point_count;
+        _basis                    = rhs._basis;
+        _data                     = rhs._data;
+        _vertex                   = rhs._vertex;
+
+        if (rhs._vbo_vertices)
+            UpdateVertexBufferObject(_usage_flag);
+    }
+    return *this;
+}
+
+// move assignment operator
+CurveBatch3 &CurveBatch3::operator=(CurveBatch3 &&rhs) noexcept
+{
+    if (this != &rhs) {
+        DeleteVertexBufferObject();
+
+        _usage_flag               = rhs._usage_flag;
+        _vbo_vertices             = rhs._vbo_vertices;
+        _prototype                = rhs._prototype;
+        _data_count               = rhs._data_count;
+        _max_order_of_derivatives = rhs._max_order_of_derivatives;
+        _div_point_count          = rhs._div_point_count;
+        _basis                    = std::move(rhs._basis);
+        _data                     = std::move(rhs._data);
+        _vertex                   = std::move(rhs._vertex);
+        _vbo_curve_count          = rhs._vbo_curve_count;
+
+        rhs._vbo_vertices    = 0;
+        rhs._vbo_curve_count = 0;
+    }
+    return *this;
+}
+
+GLboolean CurveBatch3::AddCurve(const LinearCombination3 &curve)
+{
+    if (!_prototype->HasSameBlendingFunctionsAs(curve))
+        return GL_FALSE;
+
+    GLuint curve_count = GetCurveCount();
+
+    for (GLuint i = 0; i < _data_count; ++i) {
+        _data[i].Resize(curve_count + 1);
+        _data[i].Set(curve_count, curve[i]);
+    }
+
+    return GL_TRUE;
+}
+
+GLboolean CurveBatch3::SetCurve(GLuint                    curve_index,
+                                const LinearCombination3 &curve)
+{
+    if (curve_index >= GetCurveCount() ||
+        !_prototype->HasSameBlendingFunctionsAs(curve))
+        return GL_FALSE;
+
+    for (GLuint i = 0; i < _data_count; ++i)
+        _data[i].Set(curve_index, curve[i]);
+
+    return GL_TRUE;
+}
+
+GLvoid CurveBatch3::Clear()
+{
+    DeleteVertexBufferObject();
+
+    for (GLuint i = 0; i < _data_count; ++i)
+        _data[i].Resize(0);
+
+    _vertex.clear();
+}
+
+// get/set control points
+GLboolean CurveBatch3::GetControlPoint(GLuint curve_index, GLuint data_index,
+                                       DCoordinate3 &d) const
+{
+    if (curve_index >= GetCurveCount() || data_index >= _data_count)
+        return GL_FALSE;
+
+    d = _data[data_index][curve_index];
+
+    return GL_TRUE;
+}
+
+GLboolean CurveBatch3::SetControlPoint(GLuint curve_index, GLuint data_index,
+                                       const DCoordinate3 &d)
+{
+    if (curve_index >= GetCurveCount() || data_index >= _data_count)
+        return GL_FALSE;
+
+    _data[data_index].Set(curve_index, d);
+
+    return GL_TRUE;
+}
+
+GLboolean CurveBatch3::Evaluate()
+{
+    GLuint curve_count = GetCurveCount();
+    GLuint point_count = _div_point_count;
+
+    // distance of the vertex blocks of consecutive curves
+    GLuint curve_stride = GetVertexOffset(1, 0);
+
+    _vertex.resize((size_t)curve_count * curve_stride);
+
+    // A work item evaluates a range of consecutive subdivision points of a
+    // block of consecutive curves. The accumulators are traversed by the
+    // batch kernel AxpyRange, while the vertex blocks of the curves lie far
+    // from each other, therefore the vertices are assembled in a tile, and
+    // they are copied into the vertex blocks by contiguous runs.
+    GLint block_count =
+        (GLint)((curve_count + _curve_block_size - 1) / _curve_block_size);
+    GLint range_count =
+        (GLint)((point_count + _point_range_size - 1) / _point_range_size);
+    GLint item_count = block_count * range_count;
+
+    // the tile has the layout of the vertex blocks, but it consists of only
+    // _point_range_size points
+    GLuint tile_stride =
+        (2 * _max_order_of_derivatives + 1) * _point_range_size;
+
+#pragma omp parallel if (curve_count * point_count >= batch_kernel_parallel_threshold)
+    {
+        vector<FCoordinate3> tile(_curve_block_size * tile_stride);
+
+        // the image points and the derivatives of the curves of the block
+        GLdouble x[_curve_block_size], y[_curve_block_size],
+            z[_curve_block_size];
+        GLdouble dx[_curve_block_size], dy[_curve_block_size],
+            dz[_curve_block_size];
+
+#pragma omp for schedule(static)
+        for (GLint item = 0; item < item_count; ++item) {
+            GLuint first = (item / range_count) * _curve_block_size;
+            GLuint count = min(_curve_block_size, curve_count - first);
+            GLuint begin = (item % range_count) * _point_range_size;
+            GLuint end   = min(begin + _point_range_size, point_count);
+
+            for (GLuint k = begin; k < end; ++k) {
+                for (GLuint r = 0; r <= _max_order_of_derivatives; ++r) {
+                    GLdouble *ax = r ? dx : x, *ay = r ? dy : y,
+                             *az = r ? dz : z;
+
+                    fill(ax, ax + count, 0.0);
+                    fill(ay, ay + count, 0.0);
+                    fill(az, az + count, 0.0);
+
+                    const GLdouble *basis = &_basis(r * point_count + k, 0);
+
+                    for (GLuint i = 0; i < _data_count; ++i) {
+                        // blending functions of local support vanish at
+                        // most points
+                        if (basis[i] == 0.0)
+                            continue;
+
+                        batch_kernels::AxpyRange(0, count, basis[i],
+                                                 _data[i].X() + first, ax);
+                        batch_kernels::AxpyRange(0, count, basis[i],
+                                                 _data[i].Y() + first, ay);
+                        batch_kernels::AxpyRange(0, count, basis[i],
+                                                 _data[i].Z() + first, az);
+                    }
+
+                    FCoordinate3 *vertex = &tile[0];
+
+                    if (!r) {
+                        vertex += k - begin;
+
+                        for (GLuint j = 0; j < count;
+                             ++j, vertex += tile_stride)
+                            *vertex = FCoordinate3((GLfloat)x[j],
+                                                   (GLfloat)y[j],
+                                                   (GLfloat)z[j]);
+                    } else {
+                        vertex += (2 * r - 1) * _point_range_size +
+                                  2 * (k - begin);
+
+                        for (GLuint j = 0; j < count;
+                             ++j, vertex += tile_stride) {
+                            vertex[0] = FCoordinate3(
+                                (GLfloat)x[j], (GLfloat)y[j], (GLfloat)z[j]);
+                            vertex[1] = FCoordinate3((GLfloat)(x[j] + dx[j]),
+                                                     (GLfloat)(y[j] + dy[j]),
+                                                     (GLfloat)(z[j] + dz[j]));
+                        }
+                    }
+                }
+            }
+
+            for (GLuint j = 0; j < count; ++j) {
+                const FCoordinate3 *source = &tile[j * tile_stride];
+
+                copy(source, source + (end - begin),
+                     &_vertex[GetVertexOffset(first + j, 0) + begin]);
+
+                for (GLuint r = 1; r <= _max_order_of_derivatives; ++r) {
+                    source = &tile[j * tile_stride +
+                                   (2 * r - 1) * _point_range_size];
+
+                    copy(source, source + 2 * (end - begin),
+                         &_vertex[GetVertexOffset(first + j, r) + 2 * begin]);
+                }
+            }
+        }
+    }
+
+    return GL_TRUE;
+}
+
+// vertex buffer object handling methods
+GLvoid CurveBatch3::DeleteVertexBufferObject()
+{
+    if (_vbo_vertices) {
+        glDeleteBuffers(1, &_vbo_vertices);
+        _vbo_vertices = 0;
+    }
+
+    _vbo_curve_count = 0;
+}
+
+GLboolean CurveBatch3::UpdateVertexBufferObject(GLenum usage_flag)
+{
+    if (usage_flag != GL_STREAM_DRAW && usage_flag != GL_STREAM_READ &&
+        usage_flag != GL_STREAM_COPY && usage_flag != GL_DYNAMIC_DRAW &&
+        usage_flag != GL_DYNAMIC_READ && usage_flag != GL_DYNAMIC_COPY &&
+        usage_flag != GL_STATIC_DRAW && usage_flag != GL_STATIC_READ &&
+        usage_flag != GL_STATIC_COPY)
+        return GL_FALSE;
+
+    DeleteVertexBufferObject();
+
+    _usage_flag = usage_flag;
+
+    if (_vertex.empty())
+        return GL_FALSE;
+
+    glGenBuffers(1, &_vbo_vertices);
+
+    if (!_vbo_vertices)
+        return GL_FALSE;
+
+    // the vertices of every image are uploaded by a single transfer
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo_vertices);
+    glBufferData(GL_ARRAY_BUFFER, _vertex.size() * sizeof(FCoordinate3),
+                 &_vertex[0], _usage_flag);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    _vbo_curve_count = (GLuint)(_vertex.size() / GetVertexOffset(1, 0));
+
+    return GL_TRUE;
+}
+
+GLboolean CurveBatch3::UpdateVertexBufferObjectOfCurve(GLuint curve_index)
+{
+    if (!_vbo_vertices || curve_index >= _vbo_curve_count)
+        return GL_FALSE;
+
+    GLuint first = GetVertexOffset(curve_index, 0);
+    GLuint count = GetVertexOffset(1, 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo_vertices);
+    glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(FCoordinate3),
+                    count * sizeof(FCoordinate3), &_vertex[first]);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return GL_TRUE;
+}
+
+GLboolean CurveBatch3::RenderDerivatives(GLuint order,
+                                         GLenum render_mode) const
+{
+    if (!_vbo_curve_count || order > _max_order_of_derivatives)
+        return GL_FALSE;
+
+    if (!order) {
+        if (render_mode != GL_LINE_STRIP && render_mode != GL_LINE_LOOP &&
+            render_mode != GL_POINTS)
+            return GL_FALSE;
+    } else {
+        if (render_mode != GL_LINES && render_mode != GL_POINTS)
+            return GL_FALSE;
+    }
+
+    vector<GLint>   first(_vbo_curve_count);
+    vector<GLsizei> count(_vbo_curve_count, (GLsizei)GetVertexCount(order));
+
+    for (GLuint j = 0; j < _vbo_curve_count; ++j)
+        first[j] = (GLint)GetVertexOffset(j, order);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo_vertices);
+    glVertexPointer(3, GL_FLOAT, 0, (const GLvoid *)0);
+
+    glMultiDrawArrays(render_mode, &first[0], &count[0], _vbo_curve_count);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    return GL_TRUE;
+}
+
+GLboolean CurveBatch3::RenderDerivatives(GLuint curve_index, GLuint order,
+                                         GLenum render_mode) const
+{
+    if (curve_index >= _vbo_curve_count || order > _max_order_of_derivatives)
+        return GL_FALSE;
+
+    if (!order) {
+        if (render_mode != GL_LINE_STRIP && render_mode != GL_LINE_LOOP &&
+            render_mode != GL_POINTS)
+            return GL_FALSE;
+    } else {
+        if (render_mode != GL_LINES && render_mode != GL_POINTS)
+            return GL_FALSE;
+    }
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo_vertices);
+    glVertexPointer(3, GL_FLOAT, 0, (const GLvoid *)0);
+
+    glDrawArrays(render_mode, GetVertexOffset(curve_index, order),
+                 GetVertexCount(order));
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    return GL_TRUE;
+}
+
+// the block of a curve consists of div_point_count curve points, followed by
+// 2 * div_point_count vertices for each order of derivatives
+GLuint CurveBatch3::GetVertexOffset(GLuint curve_index, GLuint order) const
+{
+    GLuint offset = curve_index * (2 * _max_order_of_derivatives + 1) *
+                    _div_point_count;
+
+    return order ? offset + (2 * order - 1) * _div_point_count : offset;
+}
+
+GLuint CurveBatch3::GetVertexCount(GLuint order) const
+{
+    return order ? 2 * _div_point_count : _div_point_count;
+}
+
+GLboolean CurveBatch3::GetImagePoint(GLuint curve_index, GLuint k,
+                                     FCoordinate3 &point) const
+{
+    if (k >= _div_point_count ||
+        GetVertexOffset(curve_index + 1, 0) > _vertex.size())
+        return GL_FALSE;
+
+    point = _vertex[GetVertexOffset(curve_index, 0) + k];
+
+    return GL_TRUE;
+}
+
+// get properties
+GLuint CurveBatch3::GetCurveCount() const
+{
+    return _data.empty() ? 0 : _data[0].GetSize();
+}
+
+GLuint CurveBatch3::GetDataCount() const { return _data_count; }
+
+GLuint CurveBatch3::GetMaximumOrderOfDerivatives() const
+{
+    return _max_order_of_derivatives;
+}
+
+GLuint CurveBatch3::GetDivPointCount() const { return _div_point_count; }
+
+GLenum CurveBatch3::GetUsageFlag() const { return _usage_flag; }
+
+// destructor
+CurveBatch3::~CurveBatch3() { DeleteVertexBufferObject(); }
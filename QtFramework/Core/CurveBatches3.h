@@ -0,0 +1,151 @@
+#pragma once
+
+#include "CoordinateArrays3.h"
+#include "DCoordinates3.h"
+#include "LinearCombination3.h"
+#include "Matrices.h"
+#include <GL/glew.h>
+#include <memory>
+#include <vector>
+
+namespace cagd {
+//------------------
+// class CurveBatch3
+//------------------
+// Stores many linear combinations that have the same blending functions
+// (see LinearCombination3::HasSameBlendingFunctionsAs), i.e., curves that
+// differ only in their control points, and evaluates their images together.
+//
+// The control points are stored in structure of arrays layout: the array
+// _data[i] holds the i-th control point of every curve. Since the curves
+// share their blending functions, their derivatives F_i^{(r)}(u_k) at the
+// subdivision points of the images are evaluated only once (by the
+// prototype curve passed to the constructor), and the image points
+//     c_j^{(r)}(u_k) = sum_i F_i^{(r)}(u_k) _data[i][j]
+// of all curves j are accumulated by the batch kernel AxpyRange, one block
+// of consecutive curves at a time. The blocks and the subdivision points
+// are distributed among multiple threads (OpenMP).
+//
+// The images of all curves share a single vertex buffer object. The vertices
+// of the j-th curve form a contiguous block, which consists of the contents
+// of the vertex buffer objects of the corresponding GenericCurve3:
+//     order 0:  div_point_count curve points c_j(u_k),
+//     order r:  2 * div_point_count vertices of the segments
+//               [c_j(u_k), c_j(u_k) + c_j^{(r)}(u_k)], r = 1, ...,
+//               max_order_of_derivatives.
+// Every image can be rendered by a single draw call at the offset returned by
+// GetVertexOffset, and the images of all curves by a single
+// glMultiDrawArrays. The offsets do not change when curves are added.
+class CurveBatch3
+{
+protected:
+    GLenum _usage_flag;
+    GLuint _vbo_vertices;
+
+    // copy of the prototype, the curves of the batch have to have the same
+    // blending functions
+    std::shared_ptr<const LinearCombination3> _prototype;
+    GLuint                                    _data_count;
+
+    // grid of the images
+    GLuint _max_order_of_derivatives;
+    GLuint _div_point_count;
+
+    // row r * div_point_count + k stores {F_i^{(r)}(u_k)}_{i=0}^{data_count-1}
+    Matrix<GLdouble> _basis;
+
+    // _data[i][j] is the i-th control point of the j-th curve
+    std::vector<DCoordinateArray3> _data;
+
+    // the images of the last evaluation in the format of the vertex buffer
+    // object, and the number of curves whose images are stored by the
+    // vertex buffer object
+    std::vector<FCoordinate3> _vertex;
+    GLuint                    _vbo_curve_count;
+
+    // the images are evaluated in blocks of consecutive curves and ranges of
+    // consecutive subdivision points, such that the accumulators and the
+    // vertices of a block and a range fit into the L1 cache
+    static const GLuint _curve_block_size = 32;
+    static const GLuint _point_range_size = 16;
+
+public:
+    // Evaluates the blending functions of the prototype at the subdivision
+    // points of LinearCombination3::GenerateImage. Throws an exception if the
+    // prototype does not provide the derivatives of its blending functions
+    // (see LinearCombination3::BlendingFunctionDerivatives), only the values
+    // of its blending functions are needed if max_order_of_derivatives is 0.
+    CurveBatch3(const LinearCombination3 &prototype,
+                GLuint max_order_of_derivatives, GLuint div_point_count,
+                GLenum usage_flag = GL_STATIC_DRAW);
+
+    // copy constructor
+    CurveBatch3(const CurveBatch3 &batch);
+
+    // move constructor, takes over the vertex buffer object of batch
+    CurveBatch3(CurveBatch3 &&batch) noexcept;
+
+    // assignment operator
+    CurveBatch3 &operator=(const CurveBatch3 &rhs);
+
+    // move assignment operator, takes over the vertex buffer object of rhs
+    CurveBatch3 &operator=(CurveBatch3 &&rhs) noexcept;
+
+    // Appends the control points of a curve that has the blending functions
+    // of the prototype. Its image is available after the next call of
+    // Evaluate.
+    GLboolean AddCurve(const LinearCombination3 &curve);
+
+    // replaces the control points of the given curve
+    GLboolean SetCurve(GLuint curve_index, const LinearCombination3 &curve);
+
+    // removes every curve, the vertex buffer object is deleted
+    GLvoid Clear();
+
+    // get/set control points
+    GLboolean GetControlPoint(GLuint curve_index, GLuint data_index,
+                              DCoordinate3 &d) const;
+    GLboolean SetControlPoint(GLuint curve_index, GLuint data_index,
+                              const DCoordinate3 &d);
+
+    // evaluates the images of all curves
+    GLboolean Evaluate();
+
+    // vertex buffer object handling methods
+    GLvoid    DeleteVertexBufferObject();
+    GLboolean UpdateVertexBufferObject(GLenum usage_flag = GL_STATIC_DRAW);
+
+    // rewrites only the vertices of the given curve in the existing vertex
+    // buffer object, e.g., after one of its control points has been moved and
+    // the batch has been evaluated again
+    GLboolean UpdateVertexBufferObjectOfCurve(GLuint curve_index);
+
+    // renders the derivatives of the given order of all curves by a single
+    // draw call, the render modes are the ones of GenericCurve3
+    GLboolean RenderDerivatives(GLuint order, GLenum render_mode) const;
+
+    // renders the derivatives of the given order of a single curve
+    GLboolean RenderDerivatives(GLuint curve_index, GLuint order,
+                                GLenum render_mode) const;
+
+    // index of the first vertex of the given curve and order in the vertex
+    // buffer object, and the number of its vertices
+    GLuint GetVertexOffset(GLuint curve_index, GLuint order) const;
+    GLuint GetVertexCount(GLuint order) const;
+
+    // the image point of the given curve at the k-th subdivision point, in
+    // single precision, as it is stored for display
+    GLboolean GetImagePoint(GLuint curve_index, GLuint k,
+                            FCoordinate3 &point) const;
+
+    // get properties
+    GLuint GetCurveCount() const;
+    GLuint GetDataCount() const;
+    GLuint GetMaximumOrderOfDerivatives() const;
+    GLuint GetDivPointCount() const;
+    GLenum GetUsageFlag() const;
+
+    // destructor
+    virtual ~CurveBatch3();
+};
+} // namespace cagd
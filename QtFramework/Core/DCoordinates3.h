@@ -2,242 +2,543 @@
 
 #include <GL/glew.h>
 #include <cmath>
+#include <cstddef>
 #include <iostream>
 
+// Compile-time selection of the representation of double precision
+// coordinates: if CAGD_SIMD_DCOORDINATE3 is defined (e.g., DEFINES +=
+// CAGD_SIMD_DCOORDINATE3 in the project file), DCoordinate3 is padded to four
+// doubles and its arithmetic operators are evaluated by AVX intrinsics (the
+// cross product requires AVX2), or by SSE2 intrinsics if AVX is not enabled.
+// The fourth double is not part of the value: it is zero after construction,
+// and no result depends on it. The padded coordinates are also 32-byte
+// aligned, provided that the compiler supports over-aligned dynamic allocation
+// (C++17), since containers would violate the alignment otherwise. Without
+// CAGD_SIMD_DCOORDINATE3, DCoordinate3 consists of three scalar doubles.
+// The padded variant speeds up compute bound evaluations, e.g., that of
+// tensor product surfaces, but it slows down loops that stream large arrays
+// of coordinates, since these move a third more memory (see the
+// coordinate-kernels benchmark in Tests/Benchmarks).
+#if defined(CAGD_SIMD_DCOORDINATE3)
+#if defined(__AVX__)
+#define CAGD_DCOORDINATE3_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CAGD_DCOORDINATE3_SSE2
+#endif
+#include <immintrin.h>
+#endif
+
 namespace cagd {
+//--------------------------------------------------------
+// storage of TCoordinate3<T>: number of stored components
+// and alignment
+//--------------------------------------------------------
+template <class T>
+struct TCoordinate3Storage
+{
+    static const GLuint      component_count = 3;
+    static const std::size_t alignment       = alignof(T);
+};
+
+#if defined(CAGD_SIMD_DCOORDINATE3)
+template <>
+struct TCoordinate3Storage<GLdouble>
+{
+    static const GLuint component_count = 4;
+#if defined(__cpp_aligned_new)
+    static const std::size_t alignment = 32;
+#else
+    static const std::size_t alignment = alignof(GLdouble);
+#endif
+};
+#endif
+
+//-------------------------------------------------------------
+// arithmetic kernels of TCoordinate3<T>: the function templates
+// process the three components one by one, while the optional
+// overloads for padded GLdouble coordinates use intrinsics
+//-------------------------------------------------------------
+namespace coordinate_kernels {
+// a += b
+template <class T>
+inline GLvoid Add(T *a, const T *b)
+{
+    a[0] += b[0];
+    a[1] += b[1];
+    a[2] += b[2];
+}
+
+// a -= b
+template <class T>
+inline GLvoid Subtract(T *a, const T *b)
+{
+    a[0] -= b[0];
+    a[1] -= b[1];
+    a[2] -= b[2];
+}
+
+// a = a x b
+template <class T>
+inline GLvoid Cross(T *a, const T *b)
+{
+    T xval = a[1] * b[2] - a[2] * b[1];
+    T yval = a[2] * b[0] - a[0] * b[2];
+    T zval = a[0] * b[1] - a[1] * b[0];
+    a[0]   = xval;
+    a[1]   = yval;
+    a[2]   = zval;
+}
+
+// <a, b>
+template <class T>
+inline T Dot(const T *a, const T *b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// a *= s
+template <class T>
+inline GLvoid Scale(T *a, T s)
+{
+    a[0] *= s;
+    a[1] *= s;
+    a[2] *= s;
+}
+
+// a /= s
+template <class T>
+inline GLvoid Divide(T *a, T s)
+{
+    a[0] /= s;
+    a[1] /= s;
+    a[2] /= s;
+}
+
+// The unaligned load and store instructions are used, since the alignment is
+// not guaranteed before C++17, and they are as fast as the aligned ones on
+// aligned addresses.
+#if defined(CAGD_DCOORDINATE3_AVX)
+inline GLvoid Add(GLdouble *a, const GLdouble *b)
+{
+    _mm256_storeu_pd(a, _mm256_add_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b)));
+}
+
+inline GLvoid Subtract(GLdouble *a, const GLdouble *b)
+{
+    _mm256_storeu_pd(a, _mm256_sub_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b)));
+}
+
+#if defined(__AVX2__)
+inline GLvoid Cross(GLdouble *a, const GLdouble *b)
+{
+    // (y, z, x) and (z, x, y) permutations of the operands
+    __m256d va    = _mm256_loadu_pd(a);
+    __m256d vb    = _mm256_loadu_pd(b);
+    __m256d a_yzx = _mm256_permute4x64_pd(va, _MM_SHUFFLE(3, 0, 2, 1));
+    __m256d a_zxy = _mm256_permute4x64_pd(va, _MM_SHUFFLE(3, 1, 0, 2));
+    __m256d b_yzx = _mm256_permute4x64_pd(vb, _MM_SHUFFLE(3, 0, 2, 1));
+    __m256d b_zxy = _mm256_permute4x64_pd(vb, _MM_SHUFFLE(3, 1, 0, 2));
+
+    _mm256_storeu_pd(a, _mm256_sub_pd(_mm256_mul_pd(a_yzx, b_zxy),
+                                      _mm256_mul_pd(a_zxy, b_yzx)));
+}
+#endif
+
+inline GLdouble Dot(const GLdouble *a, const GLdouble *b)
+{
+    // the padding is excluded from the horizontal sum
+    __m256d products = _mm256_mul_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b));
+    __m128d xy       = _mm256_castpd256_pd128(products);
+    __m128d z        = _mm256_extractf128_pd(products, 1);
+    __m128d sum      = _mm_add_sd(xy, _mm_unpackhi_pd(xy, xy));
+
+    return _mm_cvtsd_f64(_mm_add_sd(sum, z));
+}
+
+inline GLvoid Scale(GLdouble *a, GLdouble s)
+{
+    _mm256_storeu_pd(a, _mm256_mul_pd(_mm256_loadu_pd(a), _mm256_set1_pd(s)));
+}
+
+inline GLvoid Divide(GLdouble *a, GLdouble s)
+{
+    _mm256_storeu_pd(a, _mm256_div_pd(_mm256_loadu_pd(a), _mm256_set1_pd(s)));
+}
+#elif defined(CAGD_DCOORDINATE3_SSE2)
+// the components are processed as the pairs (x, y) and (z, padding)
+inline GLvoid Add(GLdouble *a, const GLdouble *b)
+{
+    _mm_storeu_pd(a, _mm_add_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)));
+    _mm_storeu_pd(a + 2, _mm_add_pd(_mm_loadu_pd(a + 2), _mm_loadu_pd(b + 2)));
+}
+
+inline GLvoid Subtract(GLdouble *a, const GLdouble *b)
+{
+    _mm_storeu_pd(a, _mm_sub_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)));
+    _mm_storeu_pd(a + 2, _mm_sub_pd(_mm_loadu_pd(a + 2), _mm_loadu_pd(b + 2)));
+}
+
+inline GLdouble Dot(const GLdouble *a, const GLdouble *b)
+{
+    __m128d xy  = _mm_mul_pd(_mm_loadu_pd(a), _mm_loadu_pd(b));
+    __m128d z   = _mm_mul_sd(_mm_loadu_pd(a + 2), _mm_loadu_pd(b + 2));
+    __m128d sum = _mm_add_sd(xy, _mm_unpackhi_pd(xy, xy));
+
+    return _mm_cvtsd_f64(_mm_add_sd(sum, z));
+}
+
+inline GLvoid Scale(GLdouble *a, GLdouble s)
+{
+    __m128d scale = _mm_set1_pd(s);
+    _mm_storeu_pd(a, _mm_mul_pd(_mm_loadu_pd(a), scale));
+    _mm_storeu_pd(a + 2, _mm_mul_pd(_mm_loadu_pd(a + 2), scale));
+}
+
+inline GLvoid Divide(GLdouble *a, GLdouble s)
+{
+    __m128d scale = _mm_set1_pd(s);
+    _mm_storeu_pd(a, _mm_div_pd(_mm_loadu_pd(a), scale));
+    _mm_storeu_pd(a + 2, _mm_div_pd(_mm_loadu_pd(a + 2), scale));
+}
+#endif
+
+#if defined(CAGD_DCOORDINATE3_SSE2) || \
+    (defined(CAGD_DCOORDINATE3_AVX) && !defined(__AVX2__))
+// Without AVX2 the four doubles cannot be permuted across the 128-bit lanes,
+// thus the pairs (x, y) and (z, padding) are combined. The scalar template
+// would store the components one by one, and the 16-byte loads of the padded
+// coordinate that follow could not be forwarded from these 8-byte stores.
+inline GLvoid Cross(GLdouble *a, const GLdouble *b)
+{
+    __m128d a_xy = _mm_loadu_pd(a), a_zw = _mm_loadu_pd(a + 2);
+    __m128d b_xy = _mm_loadu_pd(b), b_zw = _mm_loadu_pd(b + 2);
+
+    // (y, z) and (z, x)
+    __m128d a_yz = _mm_shuffle_pd(a_xy, a_zw, 1);
+    __m128d a_zx = _mm_shuffle_pd(a_zw, a_xy, 0);
+    __m128d b_yz = _mm_shuffle_pd(b_xy, b_zw, 1);
+    __m128d b_zx = _mm_shuffle_pd(b_zw, b_xy, 0);
+
+    // (x * b_y, y * b_x)
+    __m128d z_terms = _mm_mul_pd(a_xy, _mm_shuffle_pd(b_xy, b_xy, 1));
+    __m128d z = _mm_sub_sd(z_terms, _mm_unpackhi_pd(z_terms, z_terms));
+
+    // the padding is kept, and both pairs are stored as a whole
+    _mm_storeu_pd(a, _mm_sub_pd(_mm_mul_pd(a_yz, b_zx),
+                                _mm_mul_pd(a_zx, b_yz)));
+    _mm_storeu_pd(a + 2, _mm_move_sd(a_zw, z));
+}
+#endif
+} // namespace coordinate_kernels
+
 //-------------------
-// class DCoordinate3
+// class TCoordinate3
 //-------------------
-class DCoordinate3
+// Three dimensional Descartes coordinates, templated on the scalar type T.
+// Computations use DCoordinate3 (i.e., T = GLdouble), while geometry meant
+// only for display can be stored by FCoordinate3 (i.e., T = GLfloat), whose
+// arrays consist of tightly packed GLfloat triplets, thus they can be copied
+// into vertex buffer objects as they are.
+template <class T>
+class alignas(TCoordinate3Storage<T>::alignment) TCoordinate3
 {
 private:
-    GLdouble _data[3];
+    T _data[TCoordinate3Storage<T>::component_count];
 
 public:
+    typedef T ScalarType;
+
     // default constructor
-    DCoordinate3();
+    TCoordinate3();
 
     // special constructor
-    DCoordinate3(GLdouble x, GLdouble y, GLdouble z = 0.0);
+    TCoordinate3(T x, T y, T z = 0);
+
+    // converts the coordinates of another scalar type
+    template <class U>
+    explicit TCoordinate3(const TCoordinate3<U> &c);
 
     // get components by value
-    GLdouble operator[](GLuint index) const;
-    GLdouble x() const;
-    GLdouble y() const;
-    GLdouble z() const;
+    T operator[](GLuint index) const;
+    T x() const;
+    T y() const;
+    T z() const;
 
 
     // get components by reference
-    GLdouble &operator[](GLuint index);
-    GLdouble &x();
-    GLdouble &y();
-    GLdouble &z();
+    T &operator[](GLuint index);
+    T &x();
+    T &y();
+    T &z();
 
     // change sign
-    const DCoordinate3 operator+() const;
-    const DCoordinate3 operator-() const;
+    const TCoordinate3 operator+() const;
+    const TCoordinate3 operator-() const;
 
     // add
-    const DCoordinate3 operator+(const DCoordinate3 &rhs) const;
+    const TCoordinate3 operator+(const TCoordinate3 &rhs) const;
 
     // add to *this
-    DCoordinate3 &operator+=(const DCoordinate3 &rhs);
+    TCoordinate3 &operator+=(const TCoordinate3 &rhs);
 
     // subtract
-    const DCoordinate3 operator-(const DCoordinate3 &rhs) const;
+    const TCoordinate3 operator-(const TCoordinate3 &rhs) const;
 
     // subtract from *this
-    DCoordinate3 &operator-=(const DCoordinate3 &rhs);
+    TCoordinate3 &operator-=(const TCoordinate3 &rhs);
 
     // cross product
-    const DCoordinate3 operator^(const DCoordinate3 &rhs) const;
+    const TCoordinate3 operator^(const TCoordinate3 &rhs) const;
 
     // cross product, result is stored by *this
-    DCoordinate3 &operator^=(const DCoordinate3 &rhs);
+    TCoordinate3 &operator^=(const TCoordinate3 &rhs);
 
     // dot product
-    GLdouble operator*(const DCoordinate3 &rhs) const;
+    T operator*(const TCoordinate3 &rhs) const;
 
     // scale
-    const DCoordinate3 operator*(const GLdouble &rhs) const;
-    const DCoordinate3 operator/(const GLdouble &rhs) const;
+    const TCoordinate3 operator*(const T &rhs) const;
+    const TCoordinate3 operator/(const T &rhs) const;
 
     // scale *this
-    DCoordinate3 &operator*=(const GLdouble &rhs);
-    DCoordinate3 &operator/=(const GLdouble &rhs);
+    TCoordinate3 &operator*=(const T &rhs);
+    TCoordinate3 &operator/=(const T &rhs);
 
     // length
-    GLdouble length() const;
+    T length() const;
 
     // normalize
-    DCoordinate3 &normalize();
+    TCoordinate3 &normalize();
 
     // logical operators
-    GLboolean operator!=(const GLdouble &rhs) const;
+    GLboolean operator!=(const T &rhs) const;
 };
 
+// coordinates used for computations
+typedef TCoordinate3<GLdouble> DCoordinate3;
+
+// coordinates used for display only
+typedef TCoordinate3<GLfloat> FCoordinate3;
+
 //-------------------------------------
-// implementation of class DCoordinate3
+// implementation of class TCoordinate3
 //-------------------------------------
 
 // default constructor
-inline DCoordinate3::DCoordinate3() { _data[0] = _data[1] = _data[2] = 0.0; }
+template <class T>
+inline TCoordinate3<T>::TCoordinate3()
+{
+    for (GLuint i = 0; i < TCoordinate3Storage<T>::component_count; ++i)
+        _data[i] = 0;
+}
 
 // special constructor
-inline DCoordinate3::DCoordinate3(GLdouble x, GLdouble y, GLdouble z)
+template <class T>
+inline TCoordinate3<T>::TCoordinate3(T x, T y, T z)
 {
     _data[0] = x;
     _data[1] = y;
     _data[2] = z;
+
+    for (GLuint i = 3; i < TCoordinate3Storage<T>::component_count; ++i)
+        _data[i] = 0;
+}
+
+// converts the coordinates of another scalar type
+template <class T>
+template <class U>
+inline TCoordinate3<T>::TCoordinate3(const TCoordinate3<U> &c)
+{
+    _data[0] = (T)c[0];
+    _data[1] = (T)c[1];
+    _data[2] = (T)c[2];
+
+    for (GLuint i = 3; i < TCoordinate3Storage<T>::component_count; ++i)
+        _data[i] = 0;
 }
 
 // get components by value
-inline GLdouble DCoordinate3::operator[](GLuint index) const
+template <class T>
+inline T TCoordinate3<T>::operator[](GLuint index) const
 {
     return _data[index];
 }
 
-inline GLdouble DCoordinate3::x() const { return _data[0]; }
+template <class T>
+inline T TCoordinate3<T>::x() const
+{
+    return _data[0];
+}
 
-inline GLdouble DCoordinate3::y() const { return _data[1]; }
+template <class T>
+inline T TCoordinate3<T>::y() const
+{
+    return _data[1];
+}
 
-inline GLdouble DCoordinate3::z() const { return _data[2]; }
+template <class T>
+inline T TCoordinate3<T>::z() const
+{
+    return _data[2];
+}
 
 // get components by reference
-inline GLdouble &DCoordinate3::operator[](GLuint index) { return _data[index]; }
+template <class T>
+inline T &TCoordinate3<T>::operator[](GLuint index)
+{
+    return _data[index];
+}
 
-inline GLdouble &DCoordinate3::x() { return _data[0]; }
+template <class T>
+inline T &TCoordinate3<T>::x()
+{
+    return _data[0];
+}
 
-inline GLdouble &DCoordinate3::y() { return _data[1]; }
+template <class T>
+inline T &TCoordinate3<T>::y()
+{
+    return _data[1];
+}
 
-inline GLdouble &DCoordinate3::z() { return _data[2]; }
+template <class T>
+inline T &TCoordinate3<T>::z()
+{
+    return _data[2];
+}
 
 // change sign
-inline const DCoordinate3 DCoordinate3::operator+() const
+template <class T>
+inline const TCoordinate3<T> TCoordinate3<T>::operator+() const
 {
-    return DCoordinate3(_data[0], _data[1], _data[2]);
+    return TCoordinate3(_data[0], _data[1], _data[2]);
 }
 
-inline const DCoordinate3 DCoordinate3::operator-() const
+template <class T>
+inline const TCoordinate3<T> TCoordinate3<T>::operator-() const
 {
-    return DCoordinate3(-_data[0], -_data[1], -_data[2]);
+    return TCoordinate3(-_data[0], -_data[1], -_data[2]);
 }
 
 // add
-inline const DCoordinate3 DCoordinate3::operator+(const DCoordinate3 &rhs) const
+template <class T>
+inline const TCoordinate3<T>
+TCoordinate3<T>::operator+(const TCoordinate3 &rhs) const
 {
-    return DCoordinate3(_data[0] + rhs._data[0], _data[1] + rhs._data[1],
-                        _data[2] + rhs._data[2]);
+    TCoordinate3 result(*this);
+    return result += rhs;
 }
 
 // add to *this
-inline DCoordinate3 &DCoordinate3::operator+=(const DCoordinate3 &rhs)
+template <class T>
+inline TCoordinate3<T> &TCoordinate3<T>::operator+=(const TCoordinate3 &rhs)
 {
-    _data[0] += rhs._data[0];
-    _data[1] += rhs._data[1];
-    _data[2] += rhs._data[2];
+    coordinate_kernels::Add(_data, rhs._data);
     return *this;
 }
 
 // subtract
-inline const DCoordinate3 DCoordinate3::operator-(const DCoordinate3 &rhs) const
+template <class T>
+inline const TCoordinate3<T>
+TCoordinate3<T>::operator-(const TCoordinate3 &rhs) const
 {
-    return DCoordinate3(_data[0] - rhs._data[0], _data[1] - rhs._data[1],
-                        _data[2] - rhs._data[2]);
+    TCoordinate3 result(*this);
+    return result -= rhs;
 }
 
 // subtract from *this
-inline DCoordinate3 &DCoordinate3::operator-=(const DCoordinate3 &rhs)
+template <class T>
+inline TCoordinate3<T> &TCoordinate3<T>::operator-=(const TCoordinate3 &rhs)
 {
-    _data[0] -= rhs._data[0];
-    _data[1] -= rhs._data[1];
-    _data[2] -= rhs._data[2];
+    coordinate_kernels::Subtract(_data, rhs._data);
     return *this;
 }
 
 // cross product
-inline const DCoordinate3 DCoordinate3::operator^(const DCoordinate3 &rhs) const
+template <class T>
+inline const TCoordinate3<T>
+TCoordinate3<T>::operator^(const TCoordinate3 &rhs) const
 {
-    return DCoordinate3(_data[1] * rhs._data[2] - _data[2] * rhs._data[1],
-                        _data[2] * rhs._data[0] - _data[0] * rhs._data[2],
-                        _data[0] * rhs._data[1] - _data[1] * rhs._data[0]);
+    TCoordinate3 result(*this);
+    return result ^= rhs;
 }
 
 // cross product, result is stored by *this
-inline DCoordinate3 &DCoordinate3::operator^=(const DCoordinate3 &rhs)
+template <class T>
+inline TCoordinate3<T> &TCoordinate3<T>::operator^=(const TCoordinate3 &rhs)
 {
-    GLdouble xval = _data[1] * rhs._data[2] - _data[2] * rhs._data[1];
-    GLdouble yval = _data[2] * rhs._data[0] - _data[0] * rhs._data[2];
-    GLdouble zval = _data[0] * rhs._data[1] - _data[1] * rhs._data[0];
-    _data[0]      = xval;
-    _data[1]      = yval;
-    _data[2]      = zval;
-
+    coordinate_kernels::Cross(_data, rhs._data);
     return *this;
 }
 
 // dot product
-inline GLdouble DCoordinate3::operator*(const DCoordinate3 &rhs) const
+template <class T>
+inline T TCoordinate3<T>::operator*(const TCoordinate3 &rhs) const
 {
-    return _data[0] * rhs._data[0] + _data[1] * rhs._data[1] +
-           _data[2] * rhs._data[2];
+    return coordinate_kernels::Dot(_data, rhs._data);
 }
 
 // scale
-inline const DCoordinate3 DCoordinate3::operator*(const GLdouble &rhs) const
+template <class T>
+inline const TCoordinate3<T> TCoordinate3<T>::operator*(const T &rhs) const
 {
-    return DCoordinate3(_data[0] * rhs, _data[1] * rhs, _data[2] * rhs);
+    TCoordinate3 result(*this);
+    return result *= rhs;
 }
 
-inline const DCoordinate3 operator*(const GLdouble &    lhs,
-                                    const DCoordinate3 &rhs)
+template <class T>
+inline const TCoordinate3<T>
+operator*(const typename TCoordinate3<T>::ScalarType &lhs,
+          const TCoordinate3<T> &                     rhs)
 {
     return rhs * lhs;
 }
 
-inline const DCoordinate3 DCoordinate3::operator/(const GLdouble &rhs) const
+template <class T>
+inline const TCoordinate3<T> TCoordinate3<T>::operator/(const T &rhs) const
 {
-    return DCoordinate3(_data[0] / rhs, _data[1] / rhs, _data[2] / rhs);
+    TCoordinate3 result(*this);
+    return result /= rhs;
 }
 
 // scale *this
-inline DCoordinate3 &DCoordinate3::operator*=(const GLdouble &rhs)
+template <class T>
+inline TCoordinate3<T> &TCoordinate3<T>::operator*=(const T &rhs)
 {
-    _data[0] *= rhs;
-    _data[1] *= rhs;
-    _data[2] *= rhs;
-
+    coordinate_kernels::Scale(_data, rhs);
     return *this;
 }
 
-inline DCoordinate3 &DCoordinate3::operator/=(const GLdouble &rhs)
+template <class T>
+inline TCoordinate3<T> &TCoordinate3<T>::operator/=(const T &rhs)
 {
-    _data[0] /= rhs;
-    _data[1] /= rhs;
-    _data[2] /= rhs;
-
+    coordinate_kernels::Divide(_data, rhs);
     return *this;
 }
 
 // length
-inline GLdouble DCoordinate3::length() const
+template <class T>
+inline T TCoordinate3<T>::length() const
 {
     return std::sqrt((*this) * (*this));
 }
 
 // normalize
-inline DCoordinate3 &DCoordinate3::normalize()
+template <class T>
+inline TCoordinate3<T> &TCoordinate3<T>::normalize()
 {
-    GLdouble l = length();
+    T l = length();
 
-    if (l && l != 1.0)
+    if (l && l != 1)
         *this /= l;
 
     return *this;
 }
 
 // logical operators
-inline GLboolean DCoordinate3::operator!=(const GLdouble &rhs) const
+template <class T>
+inline GLboolean TCoordinate3<T>::operator!=(const T &rhs) const
 {
     return (_data[0] != rhs || _data[1] != rhs || _data[2] != rhs);
 }
@@ -247,13 +548,15 @@ inline GLboolean DCoordinate3::operator!=(const GLdouble &rhs) const
 //----------------------------------------------------------------
 
 // output to stream
-inline std::ostream &operator<<(std::ostream &lhs, const DCoordinate3 &rhs)
+template <class T>
+inline std::ostream &operator<<(std::ostream &lhs, const TCoordinate3<T> &rhs)
 {
     return lhs << rhs[0] << " " << rhs[1] << " " << rhs[2];
 }
 
 // input from stream
-inline std::istream &operator>>(std::istream &lhs, DCoordinate3 &rhs)
+template <class T>
+inline std::istream &operator>>(std::istream &lhs, TCoordinate3<T> &rhs)
 {
     return lhs >> rhs[0] >> rhs[1] >> rhs[2];
 }
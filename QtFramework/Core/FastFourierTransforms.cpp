@@ -0,0 +1,148 @@
+#include "FastFourierTransforms.h"
+#include "Constants.h"
+
+#include <cmath>
+
+using namespace cagd;
+using namespace std;
+
+// complex product without the special handling of infinities and NaNs that
+// the operator * of std::complex performs
+static inline FastFourierTransform::Complex
+Multiply(const FastFourierTransform::Complex &a,
+         const FastFourierTransform::Complex &b)
+{
+    return FastFourierTransform::Complex(a.real() * b.real() -
+                                             a.imag() * b.imag(),
+                                         a.real() * b.imag() +
+                                             a.imag() * b.real());
+}
+
+// special/default constructor
+FastFourierTransform::FastFourierTransform(GLuint size)
+    : _size(size ? size : 1)
+{
+    // the radix-2 passes either transform the data directly, or compute the
+    // cyclic convolution of Bluestein's algorithm
+    GLboolean is_power_of_two = !(_size & (_size - 1));
+
+    _padded_size = 1;
+    while (_padded_size < (is_power_of_two ? _size : 2 * _size - 1))
+        _padded_size <<= 1;
+
+    _twiddle.resize(_padded_size / 2);
+    for (GLuint k = 0; k < _padded_size / 2; ++k) {
+        GLdouble angle = -TWO_PI * k / _padded_size;
+        _twiddle[k]    = Complex(cos(angle), sin(angle));
+    }
+
+    GLuint bit_count = 0;
+    while ((1u << bit_count) < _padded_size)
+        ++bit_count;
+
+    _bit_reversal.assign(_padded_size, 0);
+    for (GLuint k = 1; k < _padded_size; ++k)
+        _bit_reversal[k] =
+            (_bit_reversal[k >> 1] >> 1) | ((k & 1) << (bit_count - 1));
+
+    if (is_power_of_two)
+        return;
+
+    // k^2 is reduced modulo 2N, so that the arguments of the trigonometric
+    // functions remain small
+    _chirp.resize(_size);
+    for (GLuint k = 0; k < _size; ++k) {
+        GLdouble angle =
+            -PI * (GLdouble)(((unsigned long long)k * k) % (2ull * _size)) /
+            _size;
+        _chirp[k] = Complex(cos(angle), sin(angle));
+    }
+
+    _kernel_spectrum.assign(_padded_size, Complex(0.0, 0.0));
+    _kernel_spectrum[0] = conj(_chirp[0]);
+    for (GLuint k = 1; k < _size; ++k) {
+        _kernel_spectrum[k] = _kernel_spectrum[_padded_size - k] =
+            conj(_chirp[k]);
+    }
+
+    _TransformPowerOfTwo(_kernel_spectrum);
+}
+
+GLuint FastFourierTransform::GetSize() const { return _size; }
+
+GLdouble FastFourierTransform::GetButterflyCount(GLuint size)
+{
+    GLboolean is_power_of_two = size && !(size & (size - 1));
+
+    GLuint padded_size = 1, bit_count = 0;
+    while (padded_size < (is_power_of_two ? size : 2 * size - 1)) {
+        padded_size <<= 1;
+        ++bit_count;
+    }
+
+    // Bluestein's algorithm performs two radix-2 transforms per call
+    return (is_power_of_two ? 1.0 : 2.0) * (padded_size / 2) * bit_count;
+}
+
+// forward transform of length _padded_size
+GLvoid FastFourierTransform::_TransformPowerOfTwo(vector<Complex> &data) const
+{
+    for (GLuint k = 0; k < _padded_size; ++k)
+        if (k < _bit_reversal[k])
+            swap(data[k], data[_bit_reversal[k]]);
+
+    for (GLuint length = 2; length <= _padded_size; length <<= 1) {
+        GLuint half   = length / 2;
+        GLuint stride = _padded_size / length;
+
+        for (GLuint start = 0; start < _padded_size; start += length) {
+            for (GLuint k = 0; k < half; ++k) {
+                Complex t = Multiply(_twiddle[k * stride], data[start + k + half]);
+
+                data[start + k + half] = data[start + k] - t;
+                data[start + k] += t;
+            }
+        }
+    }
+}
+
+GLboolean FastFourierTransform::Transform(vector<Complex> &data,
+                                          GLboolean        inverse) const
+{
+    if (data.size() != _size)
+        return GL_FALSE;
+
+    // the inverse transform is the conjugate of the forward transform of the
+    // conjugate data
+    if (inverse)
+        for (GLuint k = 0; k < _size; ++k)
+            data[k] = conj(data[k]);
+
+    if (_chirp.empty()) {
+        _TransformPowerOfTwo(data);
+    } else {
+        // X_m = w_m sum_k (x_k w_k) conj(w_{m-k}), since
+        // m k = (m^2 + k^2 - (m - k)^2) / 2
+        vector<Complex> convolution(_padded_size, Complex(0.0, 0.0));
+        for (GLuint k = 0; k < _size; ++k)
+            convolution[k] = Multiply(data[k], _chirp[k]);
+
+        _TransformPowerOfTwo(convolution);
+
+        for (GLuint k = 0; k < _padded_size; ++k)
+            convolution[k] = conj(Multiply(convolution[k], _kernel_spectrum[k]));
+
+        // inverse transform by conjugation, including the 1/M normalization
+        _TransformPowerOfTwo(convolution);
+
+        for (GLuint k = 0; k < _size; ++k)
+            data[k] = Multiply(_chirp[k], conj(convolution[k])) /
+                      (GLdouble)_padded_size;
+    }
+
+    if (inverse)
+        for (GLuint k = 0; k < _size; ++k)
+            data[k] = conj(data[k]);
+
+    return GL_TRUE;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <complex>
+#include <vector>
+
+namespace cagd {
+//---------------------------
+// class FastFourierTransform
+//---------------------------
+// Discrete Fourier transform of a fixed length in O(N log N) operations.
+// Power of two lengths are transformed by iterative radix-2 passes, while any
+// other length N is reduced to a cyclic convolution of power of two length
+// M >= 2N - 1 by Bluestein's chirp-z algorithm.
+//
+// Conventions:
+//   forward transform: X_m = sum_{k=0}^{N-1} x_k exp(-2 pi i m k / N),
+//   inverse transform: x_k = sum_{m=0}^{N-1} X_m exp(+2 pi i m k / N),
+// i.e., the inverse transform is not normalized by 1/N.
+class FastFourierTransform
+{
+public:
+    typedef std::complex<GLdouble> Complex;
+
+private:
+    GLuint _size;
+    GLuint _padded_size; // length of the radix-2 passes
+
+    std::vector<Complex> _twiddle;      // exp(-2 pi i k / M), k < M / 2
+    std::vector<GLuint>  _bit_reversal; // permutation of the radix-2 passes
+
+    // Bluestein's algorithm: the chirp w_k = exp(-pi i k^2 / N) and the
+    // spectrum of the convolution kernel built from its conjugate
+    std::vector<Complex> _chirp;
+    std::vector<Complex> _kernel_spectrum;
+
+    GLvoid _TransformPowerOfTwo(std::vector<Complex> &data) const;
+
+public:
+    // special/default constructor, precalculates the twiddle factors
+    explicit FastFourierTransform(GLuint size = 1);
+
+    GLuint GetSize() const;
+
+    // approximate cost of a transform of the given length, i.e., the number of
+    // radix-2 butterflies it performs
+    static GLdouble GetButterflyCount(GLuint size);
+
+    // transforms data in place, its length has to be equal to the size of the
+    // transform
+    GLboolean Transform(std::vector<Complex> &data,
+                        GLboolean             inverse = GL_FALSE) const;
+};
+} // namespace cagd
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <iostream>
+
+namespace cagd {
+//-------------------------------------------------------------------------
+// template class FixedMatrix
+//
+// A matrix with compile-time dimensions that stores its elements in a plain
+// row-major array. It never allocates on the heap and, since all loop bounds
+// are constants, evaluation loops over it can be fully unrolled. It is meant
+// for the small control nets and blending vectors of fixed-order patches and
+// curves, where Matrix<T> would allocate and check sizes at runtime.
+//-------------------------------------------------------------------------
+template <typename T, GLuint R, GLuint C>
+class FixedMatrix
+{
+protected:
+    T _data[R * C];
+
+public:
+    // default constructor, elements are value-initialized
+    FixedMatrix();
+
+    // get element by reference
+    T &operator()(GLuint row, GLuint column);
+
+    // get copy of an element
+    T operator()(GLuint row, GLuint column) const;
+
+    // get element by its row-major index, mainly for row and column vectors
+    T &operator[](GLuint index);
+    T  operator[](GLuint index) const;
+
+    // get dimensions
+    static constexpr GLuint GetRowCount() { return R; }
+    static constexpr GLuint GetColumnCount() { return C; }
+
+    // sets every element to the given value
+    GLvoid Fill(const T &value);
+};
+
+// row and column vectors of fixed size
+template <typename T, GLuint C>
+using FixedRowMatrix = FixedMatrix<T, 1, C>;
+
+template <typename T, GLuint R>
+using FixedColumnMatrix = FixedMatrix<T, R, 1>;
+
+//----------------------------------------------
+// implementation of template class FixedMatrix
+//----------------------------------------------
+template <typename T, GLuint R, GLuint C>
+inline FixedMatrix<T, R, C>::FixedMatrix()
+    : _data()
+{}
+
+// get element by reference
+template <typename T, GLuint R, GLuint C>
+inline T &FixedMatrix<T, R, C>::operator()(GLuint row, GLuint column)
+{
+    return _data[row * C + column];
+}
+
+// get copy of an element
+template <typename T, GLuint R, GLuint C>
+inline T FixedMatrix<T, R, C>::operator()(GLuint row, GLuint column) const
+{
+    return _data[row * C + column];
+}
+
+// get element by its row-major index
+template <typename T, GLuint R, GLuint C>
+inline T &FixedMatrix<T, R, C>::operator[](GLuint index)
+{
+    return _data[index];
+}
+
+template <typename T, GLuint R, GLuint C>
+inline T FixedMatrix<T, R, C>::operator[](GLuint index) const
+{
+    return _data[index];
+}
+
+// sets every element to the given value
+template <typename T, GLuint R, GLuint C>
+inline GLvoid FixedMatrix<T, R, C>::Fill(const T &value)
+{
+    for (GLuint i = 0; i < R * C; ++i)
+        _data[i] = value;
+}
+
+// output to stream
+template <typename T, GLuint R, GLuint C>
+std::ostream &operator<<(std::ostream &lhs, const FixedMatrix<T, R, C> &rhs)
+{
+    lhs << R << " " << C << std::endl;
+    for (GLuint r = 0; r < R; ++r) {
+        for (GLuint c = 0; c < C; ++c)
+            lhs << rhs(r, c) << " ";
+        lhs << std::endl;
+    }
+    return lhs;
+}
+} // namespace cagd
@@ -1,4 +1,5 @@
 #include "GenericCurves3.h"
+#include <vector>
 
 using namespace cagd;
 using namespace std;
@@ -11,23 +12,30 @@ using namespace std;
 GenericCurve3::GenericCurve3(GLuint maximum_order_of_derivatives,
                              GLuint point_count, GLenum usage_flag)
     : _usage_flag(usage_flag)
-    , _vbo_derivative(RowMatrix<GLuint>(maximum_order_of_derivatives + 1))
-    , _derivative(
-          Matrix<DCoordinate3>(maximum_order_of_derivatives + 1, point_count))
+    , _vbo_derivative(maximum_order_of_derivatives + 1)
+    , _derivative(maximum_order_of_derivatives + 1, point_count)
 {}
 
 // special constructor
 GenericCurve3::GenericCurve3(const Matrix<DCoordinate3> &derivative,
                              GLenum                      usage_flag)
     : _usage_flag(usage_flag)
-    , _vbo_derivative(RowMatrix<GLuint>(derivative.GetRowCount()))
+    , _vbo_derivative(derivative.GetRowCount())
     , _derivative(derivative)
 {}
 
+// special constructor
+GenericCurve3::GenericCurve3(Matrix<DCoordinate3> &&derivative,
+                             GLenum                 usage_flag)
+    : _usage_flag(usage_flag)
+    , _vbo_derivative(derivative.GetRowCount())
+    , _derivative(std::move(derivative))
+{}
+
 // copy constructor
 GenericCurve3::GenericCurve3(const GenericCurve3 &curve)
     : _usage_flag(curve._usage_flag)
-    , _vbo_derivative(RowMatrix<GLuint>(curve._vbo_derivative.GetColumnCount()))
+    , _vbo_derivative(curve._vbo_derivative.GetColumnCount())
     , _derivative(curve._derivative)
 {
     GLboolean vbo_update_is_possible = GL_TRUE;
@@ -38,6 +46,13 @@ GenericCurve3::GenericCurve3(const GenericCurve3 &curve)
         UpdateVertexBufferObjects(_usage_flag);
 }
 
+// move constructor
+GenericCurve3::GenericCurve3(GenericCurve3 &&curve) noexcept
+    : _usage_flag(curve._usage_flag)
+    , _vbo_derivative(std::move(curve._vbo_derivative))
+    , _derivative(std::move(curve._derivative))
+{}
+
 // assignment operator
 GenericCurve3 &GenericCurve3::operator=(const GenericCurve3 &rhs)
 {
@@ -57,6 +72,19 @@ GenericCurve3 &GenericCurve3::operator=(const GenericCurve3 &rhs)
     return *this;
 }
 
+// move assignment operator
+GenericCurve3 &GenericCurve3::operator=(GenericCurve3 &&rhs) noexcept
+{
+    if (this != &rhs) {
+        DeleteVertexBufferObjects();
+
+        _usage_flag     = rhs._usage_flag;
+        _vbo_derivative = std::move(rhs._vbo_derivative);
+        _derivative     = std::move(rhs._derivative);
+    }
+    return *this;
+}
+
 // vertex buffer object handling methods
 GLvoid GenericCurve3::DeleteVertexBufferObjects()
 {
@@ -150,12 +178,11 @@ GLboolean GenericCurve3::UpdateVertexBufferObjects(GLenum usage_flag)
         return GL_FALSE;
     }
 
-    for (GLuint i = 0; i < curve_point_count; ++i) {
-        for (GLuint j = 0; j < 3; ++j) {
-            *coordinate = (GLfloat)_derivative(0, i)[j];
-            ++coordinate;
-        }
-    }
+    // the buffer is an array of tightly packed single precision coordinates
+    FCoordinate3 *point = reinterpret_cast<FCoordinate3 *>(coordinate);
+
+    for (GLuint i = 0; i < curve_point_count; ++i)
+        point[i] = FCoordinate3(_derivative(0, i));
 
     if (!glUnmapBuffer(GL_ARRAY_BUFFER)) {
         glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -179,17 +206,14 @@ GLboolean GenericCurve3::UpdateVertexBufferObjects(GLenum usage_flag)
             return GL_FALSE;
         }
 
+        point = reinterpret_cast<FCoordinate3 *>(coordinate);
+
         for (GLuint i = 0; i < curve_point_count; ++i) {
             DCoordinate3 sum = _derivative(0, i);
             sum += _derivative(d, i);
 
-            for (GLint j = 0; j < 3; ++j) {
-                *coordinate       = (GLfloat)_derivative(0, i)[j];
-                *(coordinate + 3) = (GLfloat)sum[j];
-                ++coordinate;
-            }
-
-            coordinate += 3;
+            point[2 * i]     = FCoordinate3(_derivative(0, i));
+            point[2 * i + 1] = FCoordinate3(sum);
         }
 
         if (!glUnmapBuffer(GL_ARRAY_BUFFER)) {
@@ -204,6 +228,52 @@ GLboolean GenericCurve3::UpdateVertexBufferObjects(GLenum usage_flag)
     return GL_TRUE;
 }
 
+GLboolean GenericCurve3::UpdateVertexBufferObjects(GLuint first_index,
+                                                  GLuint last_index)
+{
+    GLuint curve_point_count = _derivative.GetColumnCount();
+
+    if (first_index > last_index || last_index >= curve_point_count)
+        return GL_FALSE;
+
+    for (GLuint d = 0; d < _vbo_derivative.GetColumnCount(); ++d)
+        if (!_vbo_derivative(d))
+            return GL_FALSE;
+
+    GLuint count = last_index - first_index + 1;
+
+    // curve points
+    vector<FCoordinate3> point(count);
+
+    for (GLuint i = 0; i < count; ++i)
+        point[i] = FCoordinate3(_derivative(0, first_index + i));
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo_derivative(0));
+    glBufferSubData(GL_ARRAY_BUFFER, first_index * sizeof(FCoordinate3),
+                    count * sizeof(FCoordinate3), &point[0]);
+
+    // higher order derivatives, i.e., segments that start at the curve points
+    point.resize(2 * count);
+
+    for (GLuint d = 1; d < _derivative.GetRowCount(); ++d) {
+        for (GLuint i = 0; i < count; ++i) {
+            DCoordinate3 sum = _derivative(0, first_index + i);
+            sum += _derivative(d, first_index + i);
+
+            point[2 * i]     = FCoordinate3(_derivative(0, first_index + i));
+            point[2 * i + 1] = FCoordinate3(sum);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, _vbo_derivative(d));
+        glBufferSubData(GL_ARRAY_BUFFER, 2 * first_index * sizeof(FCoordinate3),
+                        2 * count * sizeof(FCoordinate3), &point[0]);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return GL_TRUE;
+}
+
 GLfloat *GenericCurve3::MapDerivatives(GLuint order, GLenum access_mode) const
 {
     if (order >= _derivative.GetRowCount())
@@ -34,17 +34,32 @@ public:
     GenericCurve3(const Matrix<DCoordinate3> &derivative,
                   GLenum                      usage_flag = GL_STATIC_DRAW);
 
+    // special constructor, takes over the storage of derivative
+    GenericCurve3(Matrix<DCoordinate3> &&derivative,
+                  GLenum                 usage_flag = GL_STATIC_DRAW);
+
     // copy constructor
     GenericCurve3(const GenericCurve3 &curve);
 
+    // move constructor, takes over the vertex buffer objects of curve
+    GenericCurve3(GenericCurve3 &&curve) noexcept;
+
     // assignment operator
     GenericCurve3 &operator=(const GenericCurve3 &rhs);
 
+    // move assignment operator, takes over the vertex buffer objects of rhs
+    GenericCurve3 &operator=(GenericCurve3 &&rhs) noexcept;
+
     // vertex buffer object handling methods
     GLvoid    DeleteVertexBufferObjects();
     GLboolean RenderDerivatives(GLuint order, GLenum render_mode) const;
     GLboolean UpdateVertexBufferObjects(GLenum usage_flag = GL_STATIC_DRAW);
 
+    // rewrites only the vertices that belong to the curve points
+    // first_index, ..., last_index in the existing vertex buffer objects,
+    // e.g., after an incremental update of the derivatives
+    GLboolean UpdateVertexBufferObjects(GLuint first_index, GLuint last_index);
+
     GLfloat * MapDerivatives(GLuint order,
                              GLenum access_mode = GL_READ_ONLY) const;
     GLboolean UnmapDerivatives(GLuint order) const;
@@ -1,5 +1,10 @@
 #include "LinearCombination3.h"
+#include "AdaptiveCurveSampling3.h"
+#include "ArcLengthTables3.h"
+#include "BandedSquareMatrices.h"
 #include "RealSquareMatrices.h"
+#include <algorithm>
+#include <typeinfo>
 
 using namespace cagd;
 using namespace std;
@@ -16,6 +21,12 @@ LinearCombination3::Derivatives::Derivatives(
     : ColumnMatrix<DCoordinate3>(d)
 {}
 
+// move constructor
+LinearCombination3::Derivatives::Derivatives(
+    LinearCombination3::Derivatives &&d) noexcept
+    : ColumnMatrix<DCoordinate3>(std::move(d))
+{}
+
 // assignment operator
 LinearCombination3::Derivatives &LinearCombination3::Derivatives::
                                  operator=(const LinearCombination3::Derivatives &rhs)
@@ -26,13 +37,20 @@ LinearCombination3::Derivatives &LinearCombination3::Derivatives::
     return *this;
 }
 
+// move assignment operator
+LinearCombination3::Derivatives &LinearCombination3::Derivatives::
+                                 operator=(LinearCombination3::Derivatives &&rhs) noexcept
+{
+    if (this != &rhs) {
+        ColumnMatrix<DCoordinate3>::operator=(std::move(rhs));
+    }
+    return *this;
+}
+
 // set every derivative to null vector
 GLvoid LinearCombination3::Derivatives::LoadNullVectors()
 {
-    for (GLuint i = 0; i < _data.size(); ++i) {
-        for (GLuint j = 0; j < 3; ++j)
-            _data[i][0][j] = 0.0;
-    }
+    std::fill(_data.begin(), _data.end(), DCoordinate3());
 }
 
 // special constructor
@@ -43,6 +61,14 @@ LinearCombination3::LinearCombination3(GLdouble u_min, GLdouble u_max,
     , _data_usage_flag(data_usage_flag)
     , _u_min(u_min)
     , _u_max(u_max)
+    , _data_revision(0)
+    , _image_basis_max_order_of_derivatives(0)
+    , _image_basis_div_point_count(0)
+    , _image_basis_u_min(0.0)
+    , _image_basis_u_max(0.0)
+    , _maximum_image_basis_size(1u << 20)
+    , _arc_length_data_revision(0)
+    , _arc_length_segment_count(128)
 {
     _data.ResizeRows(data_count);
 }
@@ -54,11 +80,45 @@ LinearCombination3::LinearCombination3(const LinearCombination3 &lc)
     , _u_min(lc._u_min)
     , _u_max(lc._u_max)
     , _data(lc._data)
+    , _data_revision(lc._data_revision)
+    , _interpolation_knot_vector(lc._interpolation_knot_vector)
+    , _interpolation_factorization(lc._interpolation_factorization)
+    , _image_basis_max_order_of_derivatives(0)
+    , _image_basis_div_point_count(0)
+    , _image_basis_u_min(0.0)
+    , _image_basis_u_max(0.0)
+    , _maximum_image_basis_size(lc._maximum_image_basis_size)
+    , _arc_length_table(lc._arc_length_table)
+    , _arc_length_data_revision(lc._arc_length_data_revision)
+    , _arc_length_segment_count(lc._arc_length_segment_count)
 {
     if (lc._vbo_data)
         UpdateVertexBufferObjectsOfData(_data_usage_flag);
 }
 
+// move constructor
+LinearCombination3::LinearCombination3(LinearCombination3 &&lc) noexcept
+    : _vbo_data(lc._vbo_data)
+    , _data_usage_flag(lc._data_usage_flag)
+    , _u_min(lc._u_min)
+    , _u_max(lc._u_max)
+    , _data(std::move(lc._data))
+    , _data_revision(lc._data_revision)
+    , _interpolation_knot_vector(std::move(lc._interpolation_knot_vector))
+    , _interpolation_factorization(std::move(lc._interpolation_factorization))
+    , _image_basis(0, 0)
+    , _image_basis_max_order_of_derivatives(0)
+    , _image_basis_div_point_count(0)
+    , _image_basis_u_min(0.0)
+    , _image_basis_u_max(0.0)
+    , _maximum_image_basis_size(lc._maximum_image_basis_size)
+    , _arc_length_table(std::move(lc._arc_length_table))
+    , _arc_length_data_revision(lc._arc_length_data_revision)
+    , _arc_length_segment_count(lc._arc_length_segment_count)
+{
+    lc._vbo_data = 0;
+}
+
 // assignment operator
 LinearCombination3 &LinearCombination3::operator=(const LinearCombination3 &rhs)
 {
@@ -70,6 +130,18 @@ LinearCombination3 &LinearCombination3::operator=(const LinearCombination3 &rhs)
         _u_max           = rhs._u_max;
         _data            = rhs._data;
 
+        // the new revision differs from every revision that either object has
+        // used so far, thus the caches that derived classes copy from rhs, as
+        // well as the own caches of this object, are recognized as stale
+        _data_revision = max(_data_revision, rhs._data_revision) + 1;
+
+        _interpolation_knot_vector   = rhs._interpolation_knot_vector;
+        _interpolation_factorization = rhs._interpolation_factorization;
+        _arc_length_segment_count    = rhs._arc_length_segment_count;
+        _maximum_image_basis_size    = rhs._maximum_image_basis_size;
+
+        _InvalidateImageBasis();
+
         if (rhs._vbo_data)
             UpdateVertexBufferObjectsOfData(_data_usage_flag);
     }
@@ -77,6 +149,34 @@ LinearCombination3 &LinearCombination3::operator=(const LinearCombination3 &rhs)
     return *this;
 }
 
+// move assignment operator
+LinearCombination3 &LinearCombination3::
+                    operator=(LinearCombination3 &&rhs) noexcept
+{
+    if (this != &rhs) {
+        DeleteVertexBufferObjectsOfData();
+
+        _vbo_data        = rhs._vbo_data;
+        _data_usage_flag = rhs._data_usage_flag;
+        _u_min           = rhs._u_min;
+        _u_max           = rhs._u_max;
+        _data            = std::move(rhs._data);
+        _data_revision   = max(_data_revision, rhs._data_revision) + 1;
+
+        _interpolation_knot_vector = std::move(rhs._interpolation_knot_vector);
+        _interpolation_factorization =
+            std::move(rhs._interpolation_factorization);
+        _arc_length_segment_count = rhs._arc_length_segment_count;
+        _maximum_image_basis_size = rhs._maximum_image_basis_size;
+
+        _InvalidateImageBasis();
+
+        rhs._vbo_data = 0;
+    }
+
+    return *this;
+}
+
 // vbo handling methods
 GLvoid LinearCombination3::DeleteVertexBufferObjectsOfData()
 {
@@ -139,12 +239,11 @@ GLboolean LinearCombination3::UpdateVertexBufferObjectsOfData(GLenum usage_flag)
         return GL_FALSE;
     }
 
-    for (GLuint i = 0; i < data_count; ++i) {
-        for (GLuint j = 0; j < 3; ++j) {
-            *coordinate = (GLfloat)_data[i][j];
-            ++coordinate;
-        }
-    }
+    // the buffer is an array of tightly packed single precision coordinates
+    FCoordinate3 *point = reinterpret_cast<FCoordinate3 *>(coordinate);
+
+    for (GLuint i = 0; i < data_count; ++i)
+        point[i] = FCoordinate3(_data[i]);
 
     if (!glUnmapBuffer(GL_ARRAY_BUFFER)) {
         glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -166,6 +265,8 @@ DCoordinate3 LinearCombination3::operator[](GLuint index) const
 // get data by reference
 DCoordinate3 &LinearCombination3::operator[](GLuint index)
 {
+    ++_data_revision;
+
     return _data[index];
 }
 
@@ -188,24 +289,45 @@ GLboolean LinearCombination3::UpdateDataForInterpolation(
         return GL_FALSE;
     }
 
-    RealSquareMatrix collocation_matrix(data_count);
+    // the collocation matrix depends only on the knot vector, thus its
+    // factorization can be reused when only the data points change; if the
+    // blending functions are locally supported, the matrix is banded and it is
+    // factorized as such
+    if (!_interpolation_factorization ||
+        _interpolation_knot_vector != knot_vector) {
+        _interpolation_factorization.reset();
+
+        RealSquareMatrix collocation_matrix(data_count);
+
+        RowMatrix<GLdouble> current_blending_function_values(data_count);
+        for (GLuint r = 0; r < knot_vector.GetRowCount(); ++r) {
+            if (!BlendingFunctionValues(knot_vector(r),
+                                        current_blending_function_values)) {
+                //            std::cerr << "Ittinkabb!\n";
+                return GL_FALSE;
+            } else {
+                //            std::cerr << "Nem stimmel!\n";
+                if (!collocation_matrix.SetRow(
+                        r, current_blending_function_values))
+                    return GL_FALSE;
+            }
+        }
+
+        _interpolation_factorization =
+            BandedSquareMatrix::FactorizeAutomatically(collocation_matrix);
 
-    RowMatrix<GLdouble> current_blending_function_values(data_count);
-    for (GLuint r = 0; r < knot_vector.GetRowCount(); ++r) {
-        if (!BlendingFunctionValues(knot_vector(r),
-                                    current_blending_function_values)) {
-            //            std::cerr << "Ittinkabb!\n";
+        if (!_interpolation_factorization)
             return GL_FALSE;
-        } else {
-            //            std::cerr << "Nem stimmel!\n";
-            collocation_matrix.SetRow(r, current_blending_function_values);
-        }
+
+        _interpolation_knot_vector = knot_vector;
     }
 
     //    std::cerr << "Solve elott!\n";
 
-    return collocation_matrix.SolveLinearSystem(data_points_to_interpolate,
-                                                _data);
+    ++_data_revision;
+
+    return _interpolation_factorization->Solve(data_points_to_interpolate,
+                                               _data);
 }
 
 
@@ -215,6 +337,14 @@ GLvoid LinearCombination3::SetDefinitionDomain(GLdouble u_min, GLdouble u_max)
     // homework
     _u_min = u_min;
     _u_max = u_max;
+
+    // the blending functions may depend on the definition domain
+    _interpolation_factorization.reset();
+}
+
+GLuint LinearCombination3::GetDataCount() const
+{
+    return _data.GetRowCount();
 }
 
 GLvoid LinearCombination3::GetDefinitionDomain(GLdouble &u_min,
@@ -225,6 +355,23 @@ GLvoid LinearCombination3::GetDefinitionDomain(GLdouble &u_min,
     u_max = _u_max;
 }
 
+GLboolean
+LinearCombination3::HasSameBlendingFunctionsAs(const LinearCombination3 &lc) const
+{
+    return typeid(*this) == typeid(lc) &&
+           _data.GetRowCount() == lc._data.GetRowCount() &&
+           _u_min == lc._u_min && _u_max == lc._u_max;
+}
+
+GLdouble LinearCombination3::GetImageParameterValue(GLuint k,
+                                                    GLuint div_point_count) const
+{
+    if (k + 1 >= div_point_count)
+        return _u_max;
+
+    return _u_min + k * ((_u_max - _u_min) / div_point_count);
+}
+
 // generate image/arc
 GenericCurve3 *
 LinearCombination3::GenerateImage(GLuint max_order_of_derivatives,
@@ -240,32 +387,68 @@ LinearCombination3::GenerateImage(GLuint max_order_of_derivatives,
         return nullptr;
     }
 
-    // Set up derivatives:
-    GLdouble    current_val = _u_min;
-    GLdouble    u_iter      = (_u_max - _u_min) / div_point_count;
-    Derivatives current_col;
-    for (GLuint div_iter = 0; div_iter < div_point_count - 1; ++div_iter) {
+    // image(r, k) = sum_i F_i^{(r)}(u_k) _data[i], accumulated in blocks of
+    // consecutive image points, which are stored contiguously
+    if (_UpdateImageBasis(max_order_of_derivatives, div_point_count)) {
+        GLuint        data_count  = _data.GetRowCount();
+        GLuint        point_count = _image_basis.GetColumnCount();
+        DCoordinate3 *image       = &result->_derivative(0, 0);
 
-        if (!CalculateDerivatives(max_order_of_derivatives, current_val,
-                                  current_col)) {
-            delete result;
-            return nullptr;
-        }
+        const GLuint block_size  = 256;
+        GLint        block_count = (GLint)((point_count + block_size - 1) /
+                                    block_size);
 
-        if (!result->_derivative.SetColumn(div_iter, current_col)) {
-            delete result;
-            return nullptr;
+#pragma omp parallel for schedule(static) if (point_count * data_count >= 65536)
+        for (GLint b = 0; b < block_count; ++b) {
+            GLuint first = b * block_size;
+            GLuint last  = min(first + block_size, point_count);
+
+            for (GLuint c = first; c < last; ++c)
+                image[c] = DCoordinate3();
+
+            for (GLuint i = 0; i < data_count; ++i) {
+                const GLdouble *    basis = &_image_basis(i, 0);
+                const DCoordinate3 &d     = _data[i];
+
+                for (GLuint c = first; c < last; ++c)
+                    image[c] += basis[c] * d;
+            }
         }
 
-        current_val += u_iter;
+        return result;
     }
 
-    if (!CalculateDerivatives(max_order_of_derivatives, _u_max, current_col)) {
+    if (!div_point_count)
+        return result;
+
+    // Set up derivatives, they are written directly into the columns of the
+    // image. The first point is evaluated in advance, since derived classes
+    // may update their cached data at the first evaluation, the other points
+    // are evaluated by multiple threads if the derived class allows it.
+    if (!CalculateDerivativesInto(max_order_of_derivatives,
+                                  GetImageParameterValue(0, div_point_count),
+                                  result->_derivative.GetColumnView(0))) {
         delete result;
         return nullptr;
     }
 
-    if (!result->_derivative.SetColumn(div_point_count - 1, current_col)) {
+    GLint     point_count   = (GLint)div_point_count;
+    GLint     failure_count = 0;
+    GLboolean in_parallel   = div_point_count >= _parallel_image_point_count &&
+                            IsThreadSafe();
+
+#pragma omp parallel for schedule(static) if (in_parallel)
+    for (GLint k = 1; k < point_count; ++k) {
+        if (!CalculateDerivativesInto(
+                max_order_of_derivatives,
+                GetImageParameterValue(k, div_point_count),
+                result->_derivative.GetColumnView(k))) {
+#pragma omp atomic
+            ++failure_count;
+        }
+    }
+
+    if (failure_count) {
         delete result;
         return nullptr;
     }
@@ -273,5 +456,324 @@ LinearCombination3::GenerateImage(GLuint max_order_of_derivatives,
     return result;
 }
 
+// evaluator of the linear combination for the adaptive sampler, the first
+// order derivatives are always calculated, since they drive the refinement
+class LinearCombinationEvaluator3
+{
+protected:
+    const LinearCombination3 &_lc;
+    GLuint                    _order;
+
+public:
+    LinearCombinationEvaluator3(const LinearCombination3 &lc, GLuint order)
+        : _lc(lc)
+        , _order(order)
+    {}
+
+    GLboolean operator()(GLdouble u, DCoordinate3 *d) const
+    {
+        return _lc.CalculateDerivativesInto(
+            _order, u, ColumnView<DCoordinate3>(d, _order + 1, 1));
+    }
+};
+
+// generate image/arc with curvature-adaptive point spacing
+GenericCurve3 *LinearCombination3::GenerateAdaptiveImage(
+    GLuint max_order_of_derivatives, GLdouble chord_tolerance,
+    GLuint initial_div_point_count, GLuint maximum_point_count,
+    GLenum usage_flag) const
+{
+    GLuint evaluated_order = max(max_order_of_derivatives, 1u);
+
+    LinearCombinationEvaluator3 evaluator(*this, evaluated_order);
+    AdaptiveCurveSampler3<LinearCombinationEvaluator3> sampler(
+        evaluator, evaluated_order);
+
+    return sampler.GenerateImage(max_order_of_derivatives, _u_min, _u_max,
+                                 chord_tolerance, initial_div_point_count,
+                                 maximum_point_count, usage_flag);
+}
+
+// arc length parametrization
+GLboolean LinearCombination3::_UpdateArcLengthTable() const
+{
+    if (_arc_length_table && _arc_length_data_revision == _data_revision &&
+        _arc_length_table->GetSegmentCount() == _arc_length_segment_count) {
+        GLdouble u_min, u_max;
+        _arc_length_table->GetDefinitionDomain(u_min, u_max);
+
+        if (u_min == _u_min && u_max == _u_max)
+            return GL_TRUE;
+    }
+
+    std::shared_ptr<ArcLengthTable3> table(new ArcLengthTable3());
+
+    if (!table->Update(LinearCombinationEvaluator3(*this, 1), _u_min, _u_max,
+                       _arc_length_segment_count)) {
+        _arc_length_table.reset();
+        return GL_FALSE;
+    }
+
+    _arc_length_table         = table;
+    _arc_length_data_revision = _data_revision;
+
+    return GL_TRUE;
+}
+
+GLvoid LinearCombination3::SetArcLengthSegmentCount(GLuint segment_count)
+{
+    _arc_length_segment_count = max(segment_count, 1u);
+}
+
+GLboolean LinearCombination3::GetArcLength(GLdouble &length) const
+{
+    if (!_UpdateArcLengthTable())
+        return GL_FALSE;
+
+    length = _arc_length_table->GetLength();
+
+    return GL_TRUE;
+}
+
+GLboolean LinearCombination3::ArcLengthAtParameter(GLdouble  u,
+                                                   GLdouble &s) const
+{
+    if (!_UpdateArcLengthTable())
+        return GL_FALSE;
+
+    return _arc_length_table->ArcLengthAtParameter(
+        LinearCombinationEvaluator3(*this, 1), u, s);
+}
+
+GLboolean LinearCombination3::ParameterAtArcLength(GLdouble  s,
+                                                   GLdouble &u) const
+{
+    if (!_UpdateArcLengthTable())
+        return GL_FALSE;
+
+    return _arc_length_table->ParameterAtArcLength(
+        LinearCombinationEvaluator3(*this, 1), s, u);
+}
+
+// generate image/arc of equally spaced points w.r.t. the arc length
+GenericCurve3 *
+LinearCombination3::GenerateArcLengthImage(GLuint max_order_of_derivatives,
+                                           GLuint div_point_count,
+                                           GLenum usage_flag) const
+{
+    if (div_point_count < 2 || !_UpdateArcLengthTable())
+        return nullptr;
+
+    GenericCurve3 *result = nullptr;
+    result = new GenericCurve3(max_order_of_derivatives, div_point_count,
+                               usage_flag);
+
+    if (!result) {
+        return nullptr;
+    }
+
+    LinearCombinationEvaluator3 evaluator(*this, 1);
+
+    GLdouble length = _arc_length_table->GetLength();
+    GLdouble s_step = length / (div_point_count - 1);
+
+    for (GLuint k = 0; k < div_point_count; ++k) {
+        GLdouble s = (k < div_point_count - 1) ? k * s_step : length;
+        GLdouble u;
+
+        if (!_arc_length_table->ParameterAtArcLength(evaluator, s, u) ||
+            !CalculateDerivativesInto(max_order_of_derivatives, u,
+                                      result->_derivative.GetColumnView(k))) {
+            delete result;
+            return nullptr;
+        }
+    }
+
+    return result;
+}
+
+GLboolean LinearCombination3::UpdateImageIncrementally(GLuint              index,
+                                                     const DCoordinate3 &delta,
+                                                     GenericCurve3 &image)
+{
+    GLuint data_count = _data.GetRowCount();
+
+    if (index >= data_count)
+        return GL_FALSE;
+
+    GLuint max_order_of_derivatives = image.GetMaximumOrderOfDerivatives();
+    GLuint div_point_count          = image.GetPointCount();
+
+    _MoveControlPoint(index, delta);
+
+    if (!div_point_count)
+        return GL_TRUE;
+
+    // range of the changed curve points, locally supported blending
+    // functions change only a part of the image
+    GLuint first_index = div_point_count, last_index = 0;
+
+    if (_UpdateImageBasis(max_order_of_derivatives, div_point_count)) {
+        const GLdouble *basis = &_image_basis(index, 0);
+
+        for (GLuint r = 0; r <= max_order_of_derivatives; ++r) {
+            for (GLuint k = 0; k < div_point_count; ++k) {
+                GLdouble weight = basis[r * div_point_count + k];
+
+                if (weight != 0.0) {
+                    image._derivative(r, k) += weight * delta;
+
+                    first_index = min(first_index, k);
+                    last_index  = max(last_index, k);
+                }
+            }
+        }
+    } else {
+        for (GLuint k = 0; k < div_point_count; ++k) {
+            if (!CalculateDerivativesInto(
+                    max_order_of_derivatives,
+                    GetImageParameterValue(k, div_point_count),
+                    image._derivative.GetColumnView(k)))
+                return GL_FALSE;
+        }
+
+        first_index = 0;
+        last_index  = div_point_count - 1;
+    }
+
+    return _UpdateImageVertexBufferObjects(image, first_index, last_index);
+}
+
+GLvoid LinearCombination3::_MoveControlPoint(GLuint              index,
+                                             const DCoordinate3 &delta)
+{
+    _data[index] += delta;
+    ++_data_revision;
+
+    // the control polygon
+    if (_vbo_data) {
+        FCoordinate3 point(_data[index]);
+
+        glBindBuffer(GL_ARRAY_BUFFER, _vbo_data);
+        glBufferSubData(GL_ARRAY_BUFFER, index * sizeof(FCoordinate3),
+                        sizeof(FCoordinate3), &point);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+}
+
+GLboolean LinearCombination3::_UpdateImageVertexBufferObjects(
+    GenericCurve3 &image, GLuint first_index, GLuint last_index) const
+{
+    // the image may not have vertex buffer objects at all
+    GLboolean image_has_vbos = GL_TRUE;
+    for (GLuint d = 0; d < image._vbo_derivative.GetColumnCount(); ++d)
+        image_has_vbos &= (image._vbo_derivative(d) != 0);
+
+    if (image_has_vbos && first_index <= last_index)
+        return image.UpdateVertexBufferObjects(first_index, last_index);
+
+    return GL_TRUE;
+}
+
+GLvoid LinearCombination3::SetMaximumImageBasisSize(GLuint element_count)
+{
+    _maximum_image_basis_size = element_count;
+
+    // the memory of a basis that exceeds the new limit is released
+    if ((GLdouble)_image_basis.GetRowCount() * _image_basis.GetColumnCount() >
+        _maximum_image_basis_size)
+        _InvalidateImageBasis();
+}
+
+GLvoid LinearCombination3::_InvalidateImageBasis()
+{
+    // resizing would keep the capacity of the storage
+    _image_basis = Matrix<GLdouble>(0, 0);
+    _image_basis_div_point_count = 0;
+}
+
+GLboolean
+LinearCombination3::_ImageBasisIsUpToDate(GLuint max_order_of_derivatives,
+                                          GLuint div_point_count) const
+{
+    return div_point_count &&
+           _image_basis_div_point_count == div_point_count &&
+           _image_basis_max_order_of_derivatives == max_order_of_derivatives &&
+           _image_basis_u_min == _u_min && _image_basis_u_max == _u_max &&
+           _image_basis.GetRowCount() == _data.GetRowCount() &&
+           _image_basis.GetColumnCount() ==
+               (max_order_of_derivatives + 1) * div_point_count;
+}
+
+GLboolean
+LinearCombination3::_UpdateImageBasis(GLuint max_order_of_derivatives,
+                                      GLuint div_point_count) const
+{
+    GLuint data_count  = _data.GetRowCount();
+    GLuint point_count = (max_order_of_derivatives + 1) * div_point_count;
+
+    if (!div_point_count || !data_count)
+        return GL_FALSE;
+
+    if (_ImageBasisIsUpToDate(max_order_of_derivatives, div_point_count))
+        return GL_TRUE;
+
+    if ((GLdouble)point_count * data_count > _maximum_image_basis_size)
+        return GL_FALSE;
+
+    Matrix<GLdouble> values;
+    Matrix<GLdouble> basis(data_count, point_count);
+
+    // the same subdivision points as the ones of GenerateImage
+    for (GLuint k = 0; k < div_point_count; ++k) {
+        if (!BlendingFunctionDerivatives(
+                max_order_of_derivatives,
+                GetImageParameterValue(k, div_point_count), values))
+            return GL_FALSE;
+
+        for (GLuint r = 0; r <= max_order_of_derivatives; ++r)
+            for (GLuint i = 0; i < data_count; ++i)
+                basis(i, r * div_point_count + k) = values(r, i);
+    }
+
+    _image_basis                          = std::move(basis);
+    _image_basis_max_order_of_derivatives = max_order_of_derivatives;
+    _image_basis_div_point_count          = div_point_count;
+    _image_basis_u_min                    = _u_min;
+    _image_basis_u_max                    = _u_max;
+
+    return GL_TRUE;
+}
+
+GLboolean LinearCombination3::BlendingFunctionDerivatives(
+    GLuint /*max_order_of_derivatives*/, GLdouble /*u*/,
+    Matrix<GLdouble> & /*values*/) const
+{
+    return GL_FALSE;
+}
+
+GLboolean LinearCombination3::IsThreadSafe() const
+{
+    return GL_FALSE;
+}
+
+// calculates derivatives into an existing storage
+GLboolean LinearCombination3::CalculateDerivativesInto(
+    GLuint max_order_of_derivatives, GLdouble u,
+    const ColumnView<DCoordinate3> &d) const
+{
+    if (d.GetRowCount() <= max_order_of_derivatives)
+        return GL_FALSE;
+
+    Derivatives current(max_order_of_derivatives);
+    if (!CalculateDerivatives(max_order_of_derivatives, u, current))
+        return GL_FALSE;
+
+    for (GLuint r = 0; r <= max_order_of_derivatives; ++r)
+        d[r] = current[r];
+
+    return GL_TRUE;
+}
+
 // destructor
 LinearCombination3::~LinearCombination3() { DeleteVertexBufferObjectsOfData(); }
@@ -6,12 +6,20 @@
 #include "GenericCurves3.h"
 #include "Matrices.h"
 
+#include <memory>
+
 namespace cagd {
+class ArcLengthTable3;
+class LUFactorization;
+
 //-------------------------
 // class LinearCombination3
 //-------------------------
 class LinearCombination3
 {
+    // uses the same image size threshold of multithreaded evaluation
+    friend class ParametricCurve3;
+
 public:
     class Derivatives : public ColumnMatrix<DCoordinate3>
     {
@@ -22,9 +30,15 @@ public:
         // copy constructor
         Derivatives(const Derivatives &d);
 
+        // move constructor
+        Derivatives(Derivatives &&d) noexcept;
+
         // assignment operator
         Derivatives &operator=(const Derivatives &rhs);
 
+        // move assignment operator
+        Derivatives &operator=(Derivatives &&rhs) noexcept;
+
         // all inherited Descartes coordinates are set to the null vector
         GLvoid LoadNullVectors();
     };
@@ -35,6 +49,66 @@ protected:
     GLdouble                   _u_min, _u_max;
     ColumnMatrix<DCoordinate3> _data;
 
+    // incremented whenever _data may have been changed (e.g., when a control
+    // point is accessed by reference); derived classes can use it to
+    // invalidate quantities that they have precomputed from the data
+    GLuint _data_revision;
+
+    // factorized collocation matrix of the last interpolation problem, reused
+    // as long as the knot vector (and the definition domain) does not change
+    ColumnMatrix<GLdouble>                 _interpolation_knot_vector;
+    std::shared_ptr<const LUFactorization> _interpolation_factorization;
+
+    // Derivatives of the blending functions at the subdivision points of the
+    // last image: row i stores F_i^{(r)}(u_k) in its column
+    // r * div_point_count + k, i.e., in the order of the image's points.
+    // As long as the grid and the basis do not change, (re)generating the
+    // image after the control points have moved is a single matrix product.
+    mutable Matrix<GLdouble> _image_basis;
+    mutable GLuint           _image_basis_max_order_of_derivatives;
+    mutable GLuint           _image_basis_div_point_count;
+    mutable GLdouble         _image_basis_u_min, _image_basis_u_max;
+
+    // the image basis is not stored if it would have more elements, see
+    // SetMaximumImageBasisSize
+    GLuint _maximum_image_basis_size;
+
+    // images of at least this many points are evaluated by multiple threads,
+    // if their evaluation is thread-safe
+    static const GLuint _parallel_image_point_count = 256;
+
+    // arc length table of the current data and definition domain, it is
+    // built on demand by the arc length queries
+    mutable std::shared_ptr<const ArcLengthTable3> _arc_length_table;
+    mutable GLuint                                 _arc_length_data_revision;
+    GLuint                                         _arc_length_segment_count;
+
+    // derived classes have to call this method whenever their blending
+    // functions change (the definition domain is handled automatically)
+    GLvoid _InvalidateImageBasis();
+
+    // checks whether the image basis belongs to the given grid
+    GLboolean _ImageBasisIsUpToDate(GLuint max_order_of_derivatives,
+                                    GLuint div_point_count) const;
+
+    // evaluates the image basis if needed, returns GL_FALSE if the derivatives
+    // of the blending functions are not available or the basis is too large
+    GLboolean _UpdateImageBasis(GLuint max_order_of_derivatives,
+                                GLuint div_point_count) const;
+
+    // rebuilds the arc length table if the data, the definition domain or the
+    // segment count has changed
+    GLboolean _UpdateArcLengthTable() const;
+
+    // helpers of UpdateImageIncrementally: the first one moves a control
+    // point and patches the vertex buffer object of the control polygon, the
+    // second one patches the vertex buffer objects of the image in the range
+    // of the changed curve points, provided that the image has any
+    GLvoid    _MoveControlPoint(GLuint index, const DCoordinate3 &delta);
+    GLboolean _UpdateImageVertexBufferObjects(GenericCurve3 &image,
+                                              GLuint first_index,
+                                              GLuint last_index) const;
+
 public:
     // special constructor
     LinearCombination3(GLdouble u_min, GLdouble u_max, GLuint data_count,
@@ -43,9 +117,15 @@ public:
     // copy constructor
     LinearCombination3(const LinearCombination3 &lc);
 
+    // move constructor, takes over the vertex buffer object of lc
+    LinearCombination3(LinearCombination3 &&lc) noexcept;
+
     // assignment operator
     LinearCombination3 &operator=(const LinearCombination3 &rhs);
 
+    // move assignment operator, takes over the vertex buffer object of rhs
+    LinearCombination3 &operator=(LinearCombination3 &&rhs) noexcept;
+
     // vbo handling methods
     virtual GLvoid    DeleteVertexBufferObjectsOfData();
     virtual GLboolean RenderData(GLenum render_mode = GL_LINE_STRIP) const;
@@ -55,13 +135,23 @@ public:
     // get data by value
     DCoordinate3 operator[](GLuint index) const;
 
-    // get data by reference
+    // get data by reference; the referenced control point should be modified
+    // before the linear combination is evaluated again
     DCoordinate3 &operator[](GLuint index);
 
+    // number of control points
+    GLuint GetDataCount() const;
+
     // set/get definition domain
     GLvoid SetDefinitionDomain(GLdouble u_min, GLdouble u_max);
     GLvoid GetDefinitionDomain(GLdouble &u_min, GLdouble &u_max) const;
 
+    // The k-th subdivision point of an image of div_point_count points, i.e.,
+    // u_k = u_min + k (u_max - u_min) / div_point_count, while the last point
+    // is u_max. It is calculated from the index, thus the points of an image
+    // can be evaluated independently of each other.
+    GLdouble GetImageParameterValue(GLuint k, GLuint div_point_count) const;
+
     //----------------
     // abstract method
     //----------------
@@ -70,6 +160,29 @@ public:
     virtual GLboolean
     BlendingFunctionValues(GLdouble u, RowMatrix<GLdouble> &values) const = 0;
 
+    //----------------
+    // abstract method
+    //----------------
+    // returns a copy of the derived object, allocated by new
+    virtual LinearCombination3 *Clone() const = 0;
+
+    // Checks whether lc has the same blending functions as this linear
+    // combination, i.e., whether their images differ only in their control
+    // points. The default implementation compares the types, the numbers of
+    // control points and the definition domains, derived classes whose
+    // blending functions depend on further parameters (e.g., on knots) have
+    // to compare those as well.
+    virtual GLboolean
+    HasSameBlendingFunctionsAs(const LinearCombination3 &lc) const;
+
+    // Calculates the derivatives of the blending functions up to the given
+    // order, row r of values consists of {F_i^{(r)}(u)}_{i=0}^{data_count-1}.
+    // The default implementation returns GL_FALSE, i.e., the derivatives are
+    // not available, and images are generated by CalculateDerivatives.
+    virtual GLboolean
+    BlendingFunctionDerivatives(GLuint max_order_of_derivatives, GLdouble u,
+                                Matrix<GLdouble> &values) const;
+
     //----------------
     // abstract method
     //----------------
@@ -80,11 +193,83 @@ public:
                                            GLdouble u,
                                            Derivatives &d) const = 0;
 
+    // same as above, but the derivatives are written straight into the first
+    // max_order_of_derivatives + 1 elements of the given view (e.g., a column
+    // of a GenericCurve3), thus no temporary Derivatives object is needed;
+    // the default implementation falls back to CalculateDerivatives.
+    virtual GLboolean
+    CalculateDerivativesInto(GLuint max_order_of_derivatives, GLdouble u,
+                             const ColumnView<DCoordinate3> &d) const;
+
+    // Derived classes return GL_TRUE if CalculateDerivativesInto can be
+    // called by multiple threads at the same time after it has returned once,
+    // i.e., if cached data are updated only by the first call. Only then does
+    // GenerateImage evaluate the points of large images in parallel. The
+    // default implementation returns GL_FALSE.
+    // It covers only the point loop inside a single call of GenerateImage,
+    // the linear combination itself is not thread-safe: its const methods
+    // (GenerateImage, CalculateDerivatives, the arc length queries, etc.)
+    // rebuild mutable caches, thus they may not be called by several threads
+    // on the same object at the same time.
+    virtual GLboolean IsThreadSafe() const;
+
     // generate image/arc
     virtual GenericCurve3 *
     GenerateImage(GLuint max_order_of_derivatives, GLuint div_point_count,
                   GLenum usage_flag = GL_STATIC_DRAW) const;
 
+    // Generates an image with variable point spacing: the uniform grid of
+    // initial_div_point_count points is refined where the chords deviate
+    // from the arc by more than chord_tolerance, until at most
+    // maximum_point_count points are used (see AdaptiveCurveSampler3).
+    // Since the parameter values are not uniform, such images cannot be
+    // updated by UpdateImageIncrementally.
+    GenericCurve3 *
+    GenerateAdaptiveImage(GLuint max_order_of_derivatives,
+                          GLdouble chord_tolerance,
+                          GLuint initial_div_point_count = 17,
+                          GLuint maximum_point_count = 65536,
+                          GLenum usage_flag = GL_STATIC_DRAW) const;
+
+    // Arc length parametrization. The arc length function is tabulated at
+    // segment_count + 1 uniform subdivision points by Gauss-Legendre
+    // quadrature (see ArcLengthTable3), the table is rebuilt by the first
+    // query after the data or the definition domain has changed.
+    // Blending functions of high frequency need more segments.
+    GLvoid    SetArcLengthSegmentCount(GLuint segment_count);
+    GLboolean GetArcLength(GLdouble &length) const;
+    GLboolean ArcLengthAtParameter(GLdouble u, GLdouble &s) const;
+    GLboolean ParameterAtArcLength(GLdouble s, GLdouble &u) const;
+
+    // Generates an image whose points follow each other at equal arc lengths,
+    // i.e., the images of s_k = k * length / (div_point_count - 1). The
+    // derivatives are taken w.r.t. the original parameter at u(s_k).
+    GenericCurve3 *
+    GenerateArcLengthImage(GLuint max_order_of_derivatives,
+                           GLuint div_point_count,
+                           GLenum usage_flag = GL_STATIC_DRAW) const;
+
+    // Moves the control point of the given index by delta, and updates the
+    // image, which has been generated by GenerateImage on the current
+    // definition domain, by the rank-one change delta * F_index^{(r)}(u_k)
+    // instead of regenerating it. Existing vertex buffer objects of the image
+    // and of the control polygon are patched only in their changed ranges.
+    // If the derivatives of the blending functions are not available, every
+    // point of the image is re-evaluated. Derived classes whose blending
+    // functions have local support may override it to visit only the points
+    // that the moved control point influences.
+    virtual GLboolean UpdateImageIncrementally(GLuint              index,
+                                               const DCoordinate3 &delta,
+                                               GenericCurve3 &     image);
+
+    // The image basis, i.e., the derivatives of the blending functions at the
+    // points of the last image, is cached only if it has at most the given
+    // number of elements, 2^20 (8 MB) by default. Then regenerating the image
+    // is a matrix product, and UpdateImageIncrementally reads a single row of
+    // it instead of re-evaluating every point. Interactive editors of large
+    // images may raise the limit, while 0 disables the cache.
+    GLvoid SetMaximumImageBasisSize(GLuint element_count);
+
     // assure interpolation
     virtual GLboolean UpdateDataForInterpolation(
         const ColumnMatrix<GLdouble> &    knot_vector,
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "LinearCombination3.h"
+
+namespace cagd {
+//----------------------------------------
+// template class LinearCombinationEngine3
+//----------------------------------------
+// Static dispatch evaluation of linear combinations. A derived class D opts in
+// by inheriting from LinearCombinationEngine3<D> and by providing the
+// non-virtual methods
+//
+//   GLvoid _PrepareEvaluation() const;
+//       updates everything that the evaluation precomputes from the control
+//       points, it is called once before every batch of evaluations;
+//
+//   GLvoid _EvaluateDerivatives(GLuint max_order_of_derivatives, GLdouble u,
+//                               DCoordinate3 *d, GLuint stride) const;
+//       writes the derivative of order r at u into d[r * stride], it may
+//       neither allocate memory nor modify the object.
+//
+// The virtual evaluation methods of LinearCombination3 are implemented by
+// means of these, thus the GUI can still use curves through base class
+// pointers, while images are generated by a batch loop, into which the
+// evaluation is inlined, and which writes straight into the image.
+template <class Derived>
+class LinearCombinationEngine3 : public LinearCombination3
+{
+protected:
+    // Grid of the last image that was evaluated point by point. Evaluating the
+    // image basis of LinearCombination3 costs more than evaluating a single
+    // image, therefore it is evaluated only if the same grid is requested
+    // again. It is updated by the const GenerateImage, which is therefore
+    // not safe to call by several threads at the same time (see IsThreadSafe).
+    mutable GLuint   _last_image_max_order_of_derivatives;
+    mutable GLuint   _last_image_div_point_count;
+    mutable GLdouble _last_image_u_min, _last_image_u_max;
+
+    const Derived &_Self() const;
+
+public:
+    // special constructor
+    LinearCombinationEngine3(GLdouble u_min, GLdouble u_max, GLuint data_count,
+                             GLenum data_usage_flag = GL_STATIC_DRAW);
+
+    GLboolean CalculateDerivatives(GLuint max_order_of_derivatives, GLdouble u,
+                                   Derivatives &d) const;
+
+    GLboolean
+    CalculateDerivativesInto(GLuint max_order_of_derivatives, GLdouble u,
+                             const ColumnView<DCoordinate3> &d) const;
+
+    // only _PrepareEvaluation modifies cached data, and it does so only at
+    // the first evaluation after the control points have changed; as in
+    // LinearCombination3, this makes the point loop of a single image
+    // parallel, not concurrent calls on the same curve
+    GLboolean IsThreadSafe() const;
+
+    // copy constructed from the derived object
+    LinearCombination3 *Clone() const;
+
+    // evaluates the derivatives at the subdivision points of GenerateImage,
+    // column k of the (max_order_of_derivatives + 1) x div_point_count matrix
+    // derivatives receives the derivatives at u_k
+    GLboolean EvaluateImage(GLuint                max_order_of_derivatives,
+                            GLuint                div_point_count,
+                            Matrix<DCoordinate3> &derivatives) const;
+
+    GenericCurve3 *GenerateImage(GLuint max_order_of_derivatives,
+                                 GLuint div_point_count,
+                                 GLenum usage_flag = GL_STATIC_DRAW) const;
+};
+
+//----------------------------------------------------------
+// implementation of template class LinearCombinationEngine3
+//----------------------------------------------------------
+template <class Derived>
+LinearCombinationEngine3<Derived>::LinearCombinationEngine3(
+    GLdouble u_min, GLdouble u_max, GLuint data_count, GLenum data_usage_flag)
+    : LinearCombination3(u_min, u_max, data_count, data_usage_flag)
+    , _last_image_max_order_of_derivatives(0)
+    , _last_image_div_point_count(0)
+    , _last_image_u_min(0.0)
+    , _last_image_u_max(0.0)
+{}
+
+template <class Derived>
+inline const Derived &LinearCombinationEngine3<Derived>::_Self() const
+{
+    return static_cast<const Derived &>(*this);
+}
+
+template <class Derived>
+GLboolean LinearCombinationEngine3<Derived>::CalculateDerivatives(
+    GLuint max_order_of_derivatives, GLdouble u, Derivatives &d) const
+{
+    d.ResizeRows(max_order_of_derivatives + 1);
+
+    return CalculateDerivativesInto(max_order_of_derivatives, u,
+                                    d.GetColumnView(0));
+}
+
+template <class Derived>
+GLboolean LinearCombinationEngine3<Derived>::CalculateDerivativesInto(
+    GLuint max_order_of_derivatives, GLdouble u,
+    const ColumnView<DCoordinate3> &d) const
+{
+    if (d.GetRowCount() <= max_order_of_derivatives)
+        return GL_FALSE;
+
+    _Self()._PrepareEvaluation();
+    _Self()._EvaluateDerivatives(max_order_of_derivatives, u, d.GetData(),
+                                 d.GetRowStride());
+
+    return GL_TRUE;
+}
+
+template <class Derived>
+GLboolean LinearCombinationEngine3<Derived>::IsThreadSafe() const
+{
+    return GL_TRUE;
+}
+
+template <class Derived>
+LinearCombination3 *LinearCombinationEngine3<Derived>::Clone() const
+{
+    return new Derived(_Self());
+}
+
+template <class Derived>
+GLboolean LinearCombinationEngine3<Derived>::EvaluateImage(
+    GLuint max_order_of_derivatives, GLuint div_point_count,
+    Matrix<DCoordinate3> &derivatives) const
+{
+    if (!div_point_count ||
+        derivatives.GetRowCount() != max_order_of_derivatives + 1 ||
+        derivatives.GetColumnCount() != div_point_count)
+        return GL_FALSE;
+
+    _Self()._PrepareEvaluation();
+
+    // the column k of derivatives starts at element (0, k)
+    DCoordinate3 *column = &derivatives(0, 0);
+    GLuint        stride = div_point_count;
+
+    // the evaluation does not modify the object, thus the points can be
+    // evaluated by multiple threads
+    GLint point_count = (GLint)div_point_count;
+
+#pragma omp parallel for schedule(static) if (div_point_count >= _parallel_image_point_count)
+    for (GLint k = 0; k < point_count; ++k)
+        _Self()._EvaluateDerivatives(
+            max_order_of_derivatives,
+            GetImageParameterValue(k, div_point_count), column + k, stride);
+
+    return GL_TRUE;
+}
+
+template <class Derived>
+GenericCurve3 *LinearCombinationEngine3<Derived>::GenerateImage(
+    GLuint max_order_of_derivatives, GLuint div_point_count,
+    GLenum usage_flag) const
+{
+    GLboolean grid_is_repeated =
+        _last_image_div_point_count == div_point_count &&
+        _last_image_max_order_of_derivatives == max_order_of_derivatives &&
+        _last_image_u_min == _u_min && _last_image_u_max == _u_max;
+
+    if (!div_point_count || grid_is_repeated ||
+        _ImageBasisIsUpToDate(max_order_of_derivatives, div_point_count))
+        return LinearCombination3::GenerateImage(
+            max_order_of_derivatives, div_point_count, usage_flag);
+
+    _last_image_max_order_of_derivatives = max_order_of_derivatives;
+    _last_image_div_point_count          = div_point_count;
+    _last_image_u_min                    = _u_min;
+    _last_image_u_max                    = _u_max;
+
+    Matrix<DCoordinate3> derivatives(max_order_of_derivatives + 1,
+                                     div_point_count);
+
+    if (!EvaluateImage(max_order_of_derivatives, div_point_count, derivatives))
+        return nullptr;
+
+    return new GenericCurve3(std::move(derivatives), usage_flag);
+}
+} // namespace cagd
@@ -2,6 +2,7 @@
 
 #include <GL/glew.h>
 #include <iostream>
+#include <utility> // std::move
 #include <vector>
 
 #include <algorithm> // std::for_each
@@ -23,6 +24,83 @@ class ColumnMatrix;
 template <typename T>
 class TriangularMatrix;
 
+//-------------------------
+// template class BlockView
+//-------------------------
+// A lightweight non-owning view of a rectangular block of a matrix. It stores
+// a pointer to the first element together with the strides of the viewed
+// storage, thus it can be copied by value and elements can be written through
+// it without copying whole rows or columns. Use BlockView<const T> for
+// read-only access. A view is invalidated by any resize of the matrix it
+// refers to.
+template <typename T>
+class BlockView
+{
+protected:
+    T *    _data;
+    GLuint _row_count;
+    GLuint _column_count;
+    GLuint _row_stride;
+    GLuint _column_stride;
+
+public:
+    // special constructor
+    BlockView(T *data, GLuint row_count, GLuint column_count, GLuint row_stride,
+              GLuint column_stride);
+
+    // a mutable view can always be used as a read-only one
+    template <typename U>
+    BlockView(const BlockView<U> &view);
+
+    // get element by reference
+    T &operator()(GLuint row, GLuint column) const;
+
+    // get dimensions and strides
+    GLuint GetRowCount() const;
+    GLuint GetColumnCount() const;
+    GLuint GetRowStride() const;
+    GLuint GetColumnStride() const;
+
+    // pointer to the element (0, 0)
+    T *GetData() const;
+};
+
+//-----------------------
+// template class RowView
+//-----------------------
+template <typename T>
+class RowView : public BlockView<T>
+{
+public:
+    // special constructor
+    RowView(T *data, GLuint column_count, GLuint column_stride = 1);
+
+    template <typename U>
+    RowView(const RowView<U> &view);
+
+    // get element by reference
+    T &operator()(GLuint column) const;
+    T &operator[](GLuint column) const;
+};
+
+//--------------------------
+// template class ColumnView
+//--------------------------
+template <typename T>
+class ColumnView : public BlockView<T>
+{
+public:
+    // special constructor
+    ColumnView(T *data, GLuint row_count, GLuint row_stride);
+
+    template <typename U>
+    ColumnView(const ColumnView<U> &view);
+
+    // get element by reference
+    T &operator()(GLuint row) const;
+    T &operator[](GLuint row) const;
+};
+
 // forward declarations of overloaded and templated input/output from/to stream
 // operators
 template <typename T>
@@ -48,9 +126,13 @@ class Matrix
     friend std::istream &cagd::operator>><T>(std::istream &, Matrix<T> &rhs);
 
 protected:
-    GLuint                      _row_count;
-    GLuint                      _column_count;
-    std::vector<std::vector<T>> _data;
+    GLuint _row_count;
+    GLuint _column_count;
+
+    // contiguous row-major storage: element (row, column) is stored at
+    // row * _column_count + column, i.e., the row stride is _column_count and
+    // the column stride is 1
+    std::vector<T> _data;
 
 public:
     // special constructor (can also be used as a default constructor)
@@ -59,9 +141,15 @@ public:
     // copy constructor
     Matrix(const Matrix &m);
 
+    // move constructor, m is left as an empty 0 x 0 matrix
+    Matrix(Matrix &&m) noexcept;
+
     // assignment operator
     Matrix &operator=(const Matrix &m);
 
+    // move assignment operator
+    Matrix &operator=(Matrix &&m) noexcept;
+
     // get element by reference
     T &operator()(GLuint row, GLuint column);
 
@@ -72,14 +160,39 @@ public:
     GLuint GetRowCount() const;
     GLuint GetColumnCount() const;
 
+    // get strides of the underlying row-major storage
+    GLuint GetRowStride() const;
+    GLuint GetColumnStride() const;
+
     // set dimensions
     virtual GLboolean ResizeRows(GLuint row_count);
     virtual GLboolean ResizeColumns(GLuint column_count);
 
-    // update
+    // update; GL_FALSE is returned and the matrix is left unchanged if the
+    // index is out of range or if the length of the row/column differs from
+    // the column/row count of the matrix
     GLboolean SetRow(GLuint index, const RowMatrix<T> &row);
     GLboolean SetColumn(GLuint index, const ColumnMatrix<T> &column);
 
+    // comparison, matrices are equal if they have the same dimensions and
+    // elements
+    GLboolean operator==(const Matrix &rhs) const;
+    GLboolean operator!=(const Matrix &rhs) const;
+
+    // non-owning views of a row, a column, a block or the whole matrix; they
+    // remain valid until the matrix is resized
+    RowView<T>          GetRowView(GLuint row);
+    RowView<const T>    GetRowView(GLuint row) const;
+    ColumnView<T>       GetColumnView(GLuint column);
+    ColumnView<const T> GetColumnView(GLuint column) const;
+    BlockView<T>        GetBlockView(GLuint first_row, GLuint first_column,
+                                     GLuint row_count, GLuint column_count);
+    BlockView<const T>  GetBlockView(GLuint first_row, GLuint first_column,
+                                     GLuint row_count,
+                                     GLuint column_count) const;
+    BlockView<T>        GetBlockView();
+    BlockView<const T>  GetBlockView() const;
+
     // destructor
     virtual ~Matrix();
 };
@@ -140,13 +253,31 @@ class TriangularMatrix
                                              const TriangularMatrix<T> &rhs);
 
 protected:
-    GLuint                      _row_count;
-    std::vector<std::vector<T>> _data;
+    GLuint _row_count;
+
+    // packed row-major storage of the lower triangle: element (row, column),
+    // column <= row, is stored at row * (row + 1) / 2 + column
+    std::vector<T> _data;
+
+    // offset of the first element of the given row in _data
+    static GLuint _RowOffset(GLuint row);
 
 public:
     // special constructor (can also be used as a default constructor)
     TriangularMatrix(GLuint row_count = 1);
 
+    // copy constructor
+    TriangularMatrix(const TriangularMatrix &m) = default;
+
+    // move constructor, m is left as an empty matrix
+    TriangularMatrix(TriangularMatrix &&m) noexcept;
+
+    // assignment operator
+    TriangularMatrix &operator=(const TriangularMatrix &m) = default;
+
+    // move assignment operator
+    TriangularMatrix &operator=(TriangularMatrix &&m) noexcept;
+
     // get element by reference
     T &operator()(GLuint row, GLuint column);
 
@@ -162,6 +293,120 @@ public:
 
 
 
+//------------------------------------------
+// implementation of template class BlockView
+//------------------------------------------
+template <typename T>
+inline BlockView<T>::BlockView(T *data, GLuint row_count, GLuint column_count,
+                               GLuint row_stride, GLuint column_stride)
+    : _data(data)
+    , _row_count(row_count)
+    , _column_count(column_count)
+    , _row_stride(row_stride)
+    , _column_stride(column_stride)
+{}
+
+template <typename T>
+template <typename U>
+inline BlockView<T>::BlockView(const BlockView<U> &view)
+    : _data(view.GetData())
+    , _row_count(view.GetRowCount())
+    , _column_count(view.GetColumnCount())
+    , _row_stride(view.GetRowStride())
+    , _column_stride(view.GetColumnStride())
+{}
+
+// get element by reference
+template <typename T>
+inline T &BlockView<T>::operator()(GLuint row, GLuint column) const
+{
+    return _data[row * _row_stride + column * _column_stride];
+}
+
+// get dimensions and strides
+template <typename T>
+inline GLuint BlockView<T>::GetRowCount() const
+{
+    return _row_count;
+}
+template <typename T>
+inline GLuint BlockView<T>::GetColumnCount() const
+{
+    return _column_count;
+}
+template <typename T>
+inline GLuint BlockView<T>::GetRowStride() const
+{
+    return _row_stride;
+}
+template <typename T>
+inline GLuint BlockView<T>::GetColumnStride() const
+{
+    return _column_stride;
+}
+
+// pointer to the element (0, 0)
+template <typename T>
+inline T *BlockView<T>::GetData() const
+{
+    return _data;
+}
+
+
+//----------------------------------------
+// implementation of template class RowView
+//----------------------------------------
+template <typename T>
+inline RowView<T>::RowView(T *data, GLuint column_count, GLuint column_stride)
+    : BlockView<T>(data, 1, column_count, 0, column_stride)
+{}
+
+template <typename T>
+template <typename U>
+inline RowView<T>::RowView(const RowView<U> &view)
+    : BlockView<T>(view)
+{}
+
+// get element by reference
+template <typename T>
+inline T &RowView<T>::operator()(GLuint column) const
+{
+    return this->_data[column * this->_column_stride];
+}
+template <typename T>
+inline T &RowView<T>::operator[](GLuint column) const
+{
+    return this->_data[column * this->_column_stride];
+}
+
+
+//-------------------------------------------
+// implementation of template class ColumnView
+//-------------------------------------------
+template <typename T>
+inline ColumnView<T>::ColumnView(T *data, GLuint row_count, GLuint row_stride)
+    : BlockView<T>(data, row_count, 1, row_stride, 0)
+{}
+
+template <typename T>
+template <typename U>
+inline ColumnView<T>::ColumnView(const ColumnView<U> &view)
+    : BlockView<T>(view)
+{}
+
+// get element by reference
+template <typename T>
+inline T &ColumnView<T>::operator()(GLuint row) const
+{
+    return this->_data[row * this->_row_stride];
+}
+template <typename T>
+inline T &ColumnView<T>::operator[](GLuint row) const
+{
+    return this->_data[row * this->_row_stride];
+}
+
+
 //--------------------------------------------------
 // homework: implementation of template class Matrix
 //--------------------------------------------------
@@ -169,13 +414,8 @@ template <typename T>
 Matrix<T>::Matrix(GLuint row_count, GLuint column_count)
     : _row_count(row_count)
     , _column_count(column_count)
-    , _data(_row_count)
-{
-    for_each(_data.begin(), _data.end(),
-             [column_count](std::vector<T> &rowVec) {
-                 rowVec.resize(column_count);
-             });
-}
+    , _data(row_count * column_count)
+{}
 
 // copy constructor
 template <typename T>
@@ -197,18 +437,46 @@ Matrix<T> &Matrix<T>::operator=(const Matrix &m)
     return *this;
 }
 
+// move constructor
+template <typename T>
+Matrix<T>::Matrix(Matrix &&m) noexcept
+    : _row_count(m._row_count)
+    , _column_count(m._column_count)
+    , _data(std::move(m._data))
+{
+    m._row_count    = 0;
+    m._column_count = 0;
+    m._data.clear();
+}
+
+// move assignment operator
+template <typename T>
+Matrix<T> &Matrix<T>::operator=(Matrix &&m) noexcept
+{
+    if (this != &m) {
+        _row_count    = m._row_count;
+        _column_count = m._column_count;
+        _data         = std::move(m._data);
+
+        m._row_count    = 0;
+        m._column_count = 0;
+        m._data.clear();
+    }
+    return *this;
+}
+
 // get element by reference
 template <typename T>
 T &Matrix<T>::operator()(GLuint row, GLuint column)
 {
-    return _data[row][column];
+    return _data[row * _column_count + column];
 }
 
 // get copy of an element
 template <typename T>
 T Matrix<T>::operator()(GLuint row, GLuint column) const
 {
-    return _data[row][column];
+    return _data[row * _column_count + column];
 }
 
 // get dimensions
@@ -223,11 +491,25 @@ GLuint Matrix<T>::GetColumnCount() const
     return _column_count;
 }
 
+// get strides of the underlying row-major storage
+template <typename T>
+GLuint Matrix<T>::GetRowStride() const
+{
+    return _column_count;
+}
+template <typename T>
+GLuint Matrix<T>::GetColumnStride() const
+{
+    return 1;
+}
+
 // set dimensions
 template <typename T>
 GLboolean Matrix<T>::ResizeRows(GLuint row_count)
 {
-    _data.resize(row_count, std::vector<T>(_column_count));
+    // rows are stored one after the other, thus existing elements keep their
+    // positions
+    _data.resize(row_count * _column_count);
     _row_count = row_count;
 
     return true;
@@ -235,11 +517,22 @@ GLboolean Matrix<T>::ResizeRows(GLuint row_count)
 template <typename T>
 GLboolean Matrix<T>::ResizeColumns(GLuint column_count)
 {
-    std::for_each(_data.begin(), _data.end(),
-                  [column_count](std::vector<T> &rowVec) {
-                      rowVec.resize(column_count);
-                  });
+    if (column_count == _column_count)
+        return true;
+
+    // the row stride changes, so the preserved elements have to be relocated
+    std::vector<T> data(_row_count * column_count);
+    GLuint         preserved_count = std::min(column_count, _column_count);
+
+    for (GLuint r = 0; r < _row_count; ++r) {
+        std::copy(_data.begin() + r * _column_count,
+                  _data.begin() + r * _column_count + preserved_count,
+                  data.begin() + r * column_count);
+    }
+
+    _data.swap(data);
     _column_count = column_count;
+
     return true;
 }
 
@@ -247,21 +540,88 @@ GLboolean Matrix<T>::ResizeColumns(GLuint column_count)
 template <typename T>
 GLboolean Matrix<T>::SetRow(GLuint index, const RowMatrix<T> &row)
 {
-    GLuint col_index = 0;
-    std::for_each(_data[index].begin(), _data[index].end(),
-                  [&col_index, &row](T &valRef) { valRef = row[col_index++]; });
+    if (index >= _row_count || row.GetColumnCount() != _column_count)
+        return false;
+
+    std::copy(row._data.begin(), row._data.end(),
+              _data.begin() + index * _column_count);
     return true;
 }
 template <typename T>
 GLboolean Matrix<T>::SetColumn(GLuint index, const ColumnMatrix<T> &column)
 {
-    GLuint row_index = 0;
-    std::for_each(_data.begin(), _data.end(), [&](std::vector<T> &rowVec) {
-        rowVec[index] = column[row_index++];
-    });
+    if (index >= _column_count || column.GetRowCount() != _row_count)
+        return false;
+
+    for (GLuint r = 0, i = index; r < _row_count; ++r, i += _column_count) {
+        _data[i] = column._data[r];
+    }
     return true;
 }
 
+// comparison
+template <typename T>
+GLboolean Matrix<T>::operator==(const Matrix &rhs) const
+{
+    return _row_count == rhs._row_count &&
+           _column_count == rhs._column_count && _data == rhs._data;
+}
+template <typename T>
+GLboolean Matrix<T>::operator!=(const Matrix &rhs) const
+{
+    return !(*this == rhs);
+}
+
+// views
+template <typename T>
+RowView<T> Matrix<T>::GetRowView(GLuint row)
+{
+    return RowView<T>(_data.data() + row * _column_count, _column_count);
+}
+template <typename T>
+RowView<const T> Matrix<T>::GetRowView(GLuint row) const
+{
+    return RowView<const T>(_data.data() + row * _column_count, _column_count);
+}
+template <typename T>
+ColumnView<T> Matrix<T>::GetColumnView(GLuint column)
+{
+    return ColumnView<T>(_data.data() + column, _row_count, _column_count);
+}
+template <typename T>
+ColumnView<const T> Matrix<T>::GetColumnView(GLuint column) const
+{
+    return ColumnView<const T>(_data.data() + column, _row_count,
+                               _column_count);
+}
+template <typename T>
+BlockView<T> Matrix<T>::GetBlockView(GLuint first_row, GLuint first_column,
+                                     GLuint row_count, GLuint column_count)
+{
+    return BlockView<T>(_data.data() + first_row * _column_count +
+                            first_column,
+                        row_count, column_count, _column_count, 1);
+}
+template <typename T>
+BlockView<const T>
+Matrix<T>::GetBlockView(GLuint first_row, GLuint first_column,
+                        GLuint row_count, GLuint column_count) const
+{
+    return BlockView<const T>(_data.data() + first_row * _column_count +
+                                  first_column,
+                              row_count, column_count, _column_count, 1);
+}
+template <typename T>
+BlockView<T> Matrix<T>::GetBlockView()
+{
+    return GetBlockView(0, 0, _row_count, _column_count);
+}
+template <typename T>
+BlockView<const T> Matrix<T>::GetBlockView() const
+{
+    return GetBlockView(0, 0, _row_count, _column_count);
+}
+
 // destructor
 template <typename T>
 Matrix<T>::~Matrix()
@@ -280,24 +640,24 @@ RowMatrix<T>::RowMatrix(GLuint column_count)
 template <typename T>
 T &RowMatrix<T>::operator()(GLuint column)
 {
-    return this->_data[0][column];
+    return this->_data[column];
 }
 template <typename T>
 T &RowMatrix<T>::operator[](GLuint column)
 {
-    return this->_data[0][column];
+    return this->_data[column];
 }
 
 // get copy of an element
 template <typename T>
 T RowMatrix<T>::operator()(GLuint column) const
 {
-    return this->_data[0][column];
+    return this->_data[column];
 }
 template <typename T>
 T RowMatrix<T>::operator[](GLuint column) const
 {
-    return this->_data[0][column];
+    return this->_data[column];
 }
 
 // a row matrix consists of a single row
@@ -321,24 +681,24 @@ ColumnMatrix<T>::ColumnMatrix(GLuint row_count)
 template <typename T>
 T &ColumnMatrix<T>::operator()(GLuint row)
 {
-    return this->_data[row][0];
+    return this->_data[row];
 }
 template <typename T>
 T &ColumnMatrix<T>::operator[](GLuint row)
 {
-    return this->_data[row][0];
+    return this->_data[row];
 }
 
 // get copy of an element
 template <typename T>
 T ColumnMatrix<T>::operator()(GLuint row) const
 {
-    return this->_data[row][0];
+    return this->_data[row];
 }
 template <typename T>
 T ColumnMatrix<T>::operator[](GLuint row) const
 {
-    return this->_data[row][0];
+    return this->_data[row];
 }
 
 // a column matrix consists of a single column
@@ -352,31 +712,56 @@ GLboolean ColumnMatrix<T>::ResizeColumns(GLuint column_count)
 //------------------------------------------------------------
 // homework: implementation of template class TriangularMatrix
 //------------------------------------------------------------
+// offset of the first element of the given row in the packed storage
+template <typename T>
+inline GLuint TriangularMatrix<T>::_RowOffset(GLuint row)
+{
+    return row * (row + 1) / 2;
+}
+
 // special constructor (can also be used as a default constructor)
 template <typename T>
 TriangularMatrix<T>::TriangularMatrix(GLuint row_count)
     : _row_count(row_count)
-    , _data(row_count)
+    , _data(_RowOffset(row_count))
+{}
+
+// move constructor
+template <typename T>
+TriangularMatrix<T>::TriangularMatrix(TriangularMatrix &&m) noexcept
+    : _row_count(m._row_count)
+    , _data(std::move(m._data))
+{
+    m._row_count = 0;
+    m._data.clear();
+}
+
+// move assignment operator
+template <typename T>
+TriangularMatrix<T> &TriangularMatrix<T>::operator=(TriangularMatrix &&m) noexcept
 {
-    GLuint current_count = 1;
-    std::for_each(_data.begin(), _data.end(),
-                  [&current_count](std::vector<T> &rowVec) {
-                      rowVec.resize(current_count++);
-                  });
+    if (this != &m) {
+        _row_count = m._row_count;
+        _data      = std::move(m._data);
+
+        m._row_count = 0;
+        m._data.clear();
+    }
+    return *this;
 }
 
 // get element by reference
 template <typename T>
 T &TriangularMatrix<T>::operator()(GLuint row, GLuint column)
 {
-    return _data[row][column];
+    return _data[_RowOffset(row) + column];
 }
 
 // get copy of an element
 template <typename T>
 T TriangularMatrix<T>::operator()(GLuint row, GLuint column) const
 {
-    return _data[row][column];
+    return _data[_RowOffset(row) + column];
 }
 
 // get dimension
@@ -390,14 +775,11 @@ GLuint TriangularMatrix<T>::GetRowCount() const
 template <typename T>
 GLboolean TriangularMatrix<T>::ResizeRows(GLuint row_count)
 {
-    GLuint old_dim = _row_count;
-    _data.resize(row_count);
+    // rows are packed one after the other, thus existing elements keep their
+    // positions
+    _data.resize(_RowOffset(row_count));
     _row_count = row_count;
 
-    for (GLuint i = old_dim; i < row_count; ++i) {
-        _data[i].resize(i + 1);
-    }
-
     return true;
 }
 
@@ -411,12 +793,10 @@ template <typename T>
 std::ostream &operator<<(std::ostream &lhs, const Matrix<T> &rhs)
 {
     lhs << rhs._row_count << " " << rhs._column_count << std::endl;
-    for (typename std::vector<std::vector<T>>::const_iterator row =
-             rhs._data.begin();
-         row != rhs._data.end(); ++row) {
-        for (typename std::vector<T>::const_iterator column = row->begin();
-             column != row->end(); ++column)
-            lhs << *column << " ";
+    typename std::vector<T>::const_iterator element = rhs._data.begin();
+    for (GLuint r = 0; r < rhs._row_count; ++r) {
+        for (GLuint c = 0; c < rhs._column_count; ++c, ++element)
+            lhs << *element << " ";
         lhs << std::endl;
     }
     return lhs;
@@ -432,10 +812,8 @@ std::istream &operator>>(std::istream &lhs, Matrix<T> &rhs)
     rhs.ResizeRows(rowCount);
     rhs.ResizeColumns(colCount);
 
-    for (auto &row : rhs._data) {
-        for (auto &col : row) {
-            lhs >> col;
-        }
+    for (auto &element : rhs._data) {
+        lhs >> element;
     }
 
     return lhs;
@@ -447,12 +825,10 @@ template <typename T>
 std::ostream &operator<<(std::ostream &lhs, const TriangularMatrix<T> &rhs)
 {
     lhs << rhs.GetRowCount() << std::endl;
-    for (typename std::vector<std::vector<T>>::const_iterator row =
-             rhs._data.begin();
-         row != rhs._data.end(); ++row) {
-        for (typename std::vector<T>::const_iterator column = row->begin();
-             column != row->end(); ++column)
-            lhs << *column << " ";
+    typename std::vector<T>::const_iterator element = rhs._data.begin();
+    for (GLuint r = 0; r < rhs._row_count; ++r) {
+        for (GLuint c = 0; c <= r; ++c, ++element)
+            lhs << *element << " ";
         lhs << std::endl;
     }
     return lhs;
@@ -467,10 +843,8 @@ std::istream &operator>>(std::istream &lhs, TriangularMatrix<T> &rhs)
 
     rhs.ResizeRows(rowCount);
 
-    for (auto &row : rhs._data) {
-        for (auto &col : row) {
-            lhs >> col;
-        }
+    for (auto &element : rhs._data) {
+        lhs >> element;
     }
 
     return lhs;
@@ -1,13 +1,55 @@
 #include "RealSquareMatrices.h"
 
+#include <cfloat>
+
 using namespace cagd;
 using namespace std;
 
 
+//----------------------------------------
+// implementation of class LUFactorization
+//----------------------------------------
+LUFactorization::LUFactorization(GLuint size, const vector<GLdouble> &lu,
+                                 const vector<GLuint> &row_permutation)
+    : _size(size)
+    , _is_banded(GL_FALSE)
+    , _lower_bandwidth(0)
+    , _upper_bandwidth(0)
+    , _lu(lu)
+    , _row_permutation(row_permutation)
+{}
+
+LUFactorization::LUFactorization(GLuint size, GLuint lower_bandwidth,
+                                 GLuint upper_bandwidth,
+                                 const vector<GLdouble> &lu,
+                                 const vector<GLuint> &row_permutation)
+    : _size(size)
+    , _is_banded(GL_TRUE)
+    , _lower_bandwidth(lower_bandwidth)
+    , _upper_bandwidth(upper_bandwidth)
+    , _lu(lu)
+    , _row_permutation(row_permutation)
+{}
+
+GLuint LUFactorization::GetSize() const { return _size; }
+
+GLboolean LUFactorization::IsBanded() const { return _is_banded; }
+
+
+//-----------------------------------------
+// implementation of class RealSquareMatrix
+//-----------------------------------------
 void RealSquareMatrix::_copy(const RealSquareMatrix &m)
 {
     _row_permutation          = m._row_permutation;
-    _lu_decomposition_is_done = _lu_decomposition_is_done;
+    _lu_decomposition_is_done = m._lu_decomposition_is_done;
+
+    _mixed_precision_is_enabled     = m._mixed_precision_is_enabled;
+    _maximum_refinement_count       = m._maximum_refinement_count;
+    _float_lu_decomposition_is_done = m._float_lu_decomposition_is_done;
+    _float_lu                       = m._float_lu;
+    _float_row_permutation          = m._float_row_permutation;
+    _refinement_report              = m._refinement_report;
 }
 
 // copy constructor
@@ -17,35 +59,78 @@ RealSquareMatrix::RealSquareMatrix(const RealSquareMatrix &m)
     _copy(m);
 }
 
+// move constructor
+RealSquareMatrix::RealSquareMatrix(RealSquareMatrix &&m) noexcept
+    : Matrix<GLdouble>(std::move(m))
+    , _lu_decomposition_is_done(m._lu_decomposition_is_done)
+    , _row_permutation(std::move(m._row_permutation))
+    , _mixed_precision_is_enabled(m._mixed_precision_is_enabled)
+    , _maximum_refinement_count(m._maximum_refinement_count)
+    , _float_lu_decomposition_is_done(m._float_lu_decomposition_is_done)
+    , _float_lu(std::move(m._float_lu))
+    , _float_row_permutation(std::move(m._float_row_permutation))
+    , _refinement_report(m._refinement_report)
+{
+    m._lu_decomposition_is_done       = GL_FALSE;
+    m._float_lu_decomposition_is_done = GL_FALSE;
+}
+
 // assignment operator
 RealSquareMatrix &RealSquareMatrix::operator=(const RealSquareMatrix &rhs)
 {
     if (this != &rhs) {
-        _data         = _data;
-        _row_count    = rhs._row_count;
-        _column_count = rhs._column_count;
+        Matrix<GLdouble>::operator=(rhs);
         _copy(rhs);
     }
     return *this;
 }
 
+// move assignment operator
+RealSquareMatrix &RealSquareMatrix::operator=(RealSquareMatrix &&rhs) noexcept
+{
+    if (this != &rhs) {
+        Matrix<GLdouble>::operator=(std::move(rhs));
+        _lu_decomposition_is_done = rhs._lu_decomposition_is_done;
+        _row_permutation          = std::move(rhs._row_permutation);
+
+        _mixed_precision_is_enabled     = rhs._mixed_precision_is_enabled;
+        _maximum_refinement_count       = rhs._maximum_refinement_count;
+        _float_lu_decomposition_is_done = rhs._float_lu_decomposition_is_done;
+        _float_lu                       = std::move(rhs._float_lu);
+        _float_row_permutation = std::move(rhs._float_row_permutation);
+        _refinement_report     = rhs._refinement_report;
+
+        rhs._lu_decomposition_is_done       = GL_FALSE;
+        rhs._float_lu_decomposition_is_done = GL_FALSE;
+    }
+    return *this;
+}
+
 // square matrices have the same number of rows and columns!
 GLboolean RealSquareMatrix::ResizeRows(GLuint row_count)
 {
     Matrix<GLdouble>::ResizeRows(row_count);
     Matrix<GLdouble>::ResizeColumns(row_count);
+    _lu_decomposition_is_done       = GL_FALSE;
+    _float_lu_decomposition_is_done = GL_FALSE;
     return true;
 }
 GLboolean RealSquareMatrix::ResizeColumns(GLuint row_count)
 {
     Matrix<GLdouble>::ResizeRows(row_count);
     Matrix<GLdouble>::ResizeColumns(row_count);
+    _lu_decomposition_is_done       = GL_FALSE;
+    _float_lu_decomposition_is_done = GL_FALSE;
     return true;
 }
 
 RealSquareMatrix::RealSquareMatrix(GLuint size)
     : Matrix<GLdouble>(size, size)
     , _lu_decomposition_is_done(GL_FALSE)
+    , _mixed_precision_is_enabled(GL_FALSE)
+    , _maximum_refinement_count(10)
+    , _float_lu_decomposition_is_done(GL_FALSE)
+    , _refinement_report{0, 0.0, GL_FALSE}
 {}
 
 GLboolean RealSquareMatrix::PerformLUDecomposition()
@@ -56,80 +141,328 @@ GLboolean RealSquareMatrix::PerformLUDecomposition()
     if (_row_count <= 1)
         return GL_FALSE;
 
-    const GLdouble tiny = numeric_limits<GLdouble>::min();
+    _row_permutation.resize(_row_count);
+
+    if (!_DecomposeInPlace(_row_count, _data.data(), _row_permutation.data()))
+        return GL_FALSE;
 
-    GLuint           size = (GLuint)_data.size();
-    vector<GLdouble> implicit_scaling_of_each_row(size);
+    _lu_decomposition_is_done = GL_TRUE;
 
-    _row_permutation.resize(size);
+    return GL_TRUE;
+}
+
+// the decomposition is templated on the scalar type S, since the mixed
+// precision solver factorizes a GLfloat copy of the matrix
+template <class S>
+GLboolean RealSquareMatrix::_DecomposeInPlace(GLuint size, S *data,
+                                              GLuint *row_permutation)
+{
+    const S tiny = numeric_limits<S>::min();
+
+    vector<S> implicit_scaling_of_each_row(size);
 
     GLdouble row_interchanges = 1.0;
 
     //-------------------------------------------------------
     // loop over rows to get the implicit scaling information
     //-------------------------------------------------------
-    vector<GLdouble>::iterator its = implicit_scaling_of_each_row.begin();
-    for (vector<vector<GLdouble>>::const_iterator itr = _data.begin();
-         itr < _data.end(); ++itr) {
-        GLdouble big = 0.0;
-        for (vector<GLdouble>::const_iterator itc = itr->begin();
-             itc < itr->end(); ++itc) {
-            GLdouble temp = abs(*itc);
+    for (GLuint i = 0; i < size; ++i) {
+        const S *row = &data[i * size];
+
+        S big = 0;
+        for (GLuint j = 0; j < size; ++j) {
+            S temp = abs(row[j]);
             if (temp > big)
                 big = temp;
         }
 
-        if (big == 0.0) {
+        if (big == 0) {
             // the matrix is singular
             return GL_FALSE;
         }
-        *its = 1.0 / big;
-        ++its;
+        implicit_scaling_of_each_row[i] = 1 / big;
     }
 
-    //-----------------------------------
-    // search for the largest pivot element
-    //-----------------------------------
-    for (GLuint k = 0; k < size; ++k) {
-        GLuint   imax = k;
-        GLdouble big  = 0.0;
-        for (GLuint i = k; i < size; ++i) {
-            GLdouble temp = implicit_scaling_of_each_row[i] * abs(_data[i][k]);
-            if (temp > big) {
-                big  = temp;
-                imax = i;
+    //-------------------------------------------------------------------
+    // blocked right-looking elimination: the columns are processed in
+    // panels of width _lu_panel_width, each panel is factorized with scaled
+    // partial pivoting, then the block row to its right and the trailing
+    // submatrix are updated
+    //-------------------------------------------------------------------
+    for (GLuint panel_begin = 0; panel_begin < size;
+         panel_begin += _lu_panel_width) {
+        GLuint panel_end = min(panel_begin + _lu_panel_width, size);
+
+        //-------------------------------------------------------------
+        // factorize the panel, i.e., columns [panel_begin, panel_end)
+        //-------------------------------------------------------------
+        for (GLuint k = panel_begin; k < panel_end; ++k) {
+            // search for the largest pivot element
+            GLuint imax = k;
+            S      big  = 0;
+            for (GLuint i = k; i < size; ++i) {
+                S temp =
+                    implicit_scaling_of_each_row[i] * abs(data[i * size + k]);
+                if (temp > big) {
+                    big  = temp;
+                    imax = i;
+                }
+            }
+
+            S *row_k = &data[k * size];
+
+            // do we need to interchange rows?
+            if (k != imax) {
+                swap_ranges(row_k, row_k + size, &data[imax * size]);
+                // change the parity of row_interchanges
+                row_interchanges = -row_interchanges;
+                // also interchange the scale factor
+                implicit_scaling_of_each_row[imax] =
+                    implicit_scaling_of_each_row[k];
+            }
+
+            row_permutation[k] = imax;
+            if (row_k[k] == 0)
+                row_k[k] = tiny;
+
+            // divide by pivot element and reduce the remaining columns of the
+            // panel only
+            for (GLuint i = k + 1; i < size; ++i) {
+                S *row_i = &data[i * size];
+                S  temp  = row_i[k] /= row_k[k];
+
+#pragma omp simd
+                for (GLuint j = k + 1; j < panel_end; ++j)
+                    row_i[j] -= temp * row_k[j];
             }
         }
 
-        // do we need to interchange rows?
-        if (k != imax) {
-            for (GLuint j = 0; j < size; ++j) {
-                GLdouble temp  = _data[imax][j];
-                _data[imax][j] = _data[k][j];
-                _data[k][j]    = temp;
+        if (panel_end == size)
+            break;
+
+        GLint trailing_count = (GLint)(size - panel_end);
+
+        //-------------------------------------------------------------
+        // update the block row to the right of the panel:
+        // U_12 = L_11^{-1} * A_12
+        //-------------------------------------------------------------
+        for (GLuint k = panel_begin; k < panel_end; ++k) {
+            const S *row_k = &data[k * size];
+            for (GLuint i = k + 1; i < panel_end; ++i) {
+                S *     row_i = &data[i * size];
+                const S l_ik  = row_i[k];
+
+#pragma omp simd
+                for (GLuint j = panel_end; j < size; ++j)
+                    row_i[j] -= l_ik * row_k[j];
             }
-            // change the parity of row_interchanges
-            row_interchanges = -row_interchanges;
-            // also interchange the scale factor
-            implicit_scaling_of_each_row[imax] =
-                implicit_scaling_of_each_row[k];
         }
 
-        _row_permutation[k] = imax;
-        if (_data[k][k] == 0.0)
-            _data[k][k] = tiny;
+        //-------------------------------------------------------------
+        // update the trailing submatrix: A_22 -= L_21 * U_12
+        // rows are independent of each other, thus they are distributed
+        // among threads, while the innermost loop runs over contiguous
+        // memory; row i differs from the rows k of the panel, thus the
+        // loop is vectorized without the runtime aliasing checks that the
+        // default cost model of -O2 rejects
+        //-------------------------------------------------------------
+#pragma omp parallel for schedule(static) if (trailing_count >= _lu_parallel_threshold)
+        for (GLint t = 0; t < trailing_count; ++t) {
+            S *row_i = &data[(panel_end + t) * size];
 
-        for (GLuint i = k + 1; i < size; ++i) {
-            // divide by pivot element
-            GLdouble temp = _data[i][k] /= _data[k][k];
+            for (GLuint j_begin = panel_end; j_begin < size;
+                 j_begin += _lu_column_block_width) {
+                GLuint j_end = min(j_begin + _lu_column_block_width, size);
 
-            // reduce remaining submatrix
-            for (GLuint j = k + 1; j < size; ++j)
-                _data[i][j] -= temp * _data[k][j];
+                for (GLuint k = panel_begin; k < panel_end; ++k) {
+                    const S  l_ik  = row_i[k];
+                    const S *row_k = &data[k * size];
+
+#pragma omp simd
+                    for (GLuint j = j_begin; j < j_end; ++j)
+                        row_i[j] -= l_ik * row_k[j];
+                }
+            }
         }
     }
 
-    _lu_decomposition_is_done = GL_TRUE;
-
     return GL_TRUE;
 }
+
+shared_ptr<const LUFactorization> RealSquareMatrix::GetLUFactorization()
+{
+    if (!PerformLUDecomposition())
+        return shared_ptr<const LUFactorization>();
+
+    return shared_ptr<const LUFactorization>(
+        new LUFactorization(_row_count, _data, _row_permutation));
+}
+
+// enables or disables the mixed precision mode of SolveLinearSystem
+GLvoid RealSquareMatrix::SetMixedPrecision(GLboolean enabled,
+                                           GLuint    maximum_refinement_count)
+{
+    _mixed_precision_is_enabled = enabled;
+    _maximum_refinement_count   = maximum_refinement_count;
+}
+
+GLboolean RealSquareMatrix::IsMixedPrecisionEnabled() const
+{
+    return _mixed_precision_is_enabled;
+}
+
+const RealSquareMatrix::RefinementReport &
+RealSquareMatrix::GetRefinementReport() const
+{
+    return _refinement_report;
+}
+
+// mixed precision solver with iterative refinement
+GLboolean RealSquareMatrix::_SolveInMixedPrecision(Matrix<GLdouble> &x)
+{
+    GLuint size      = _row_count;
+    GLuint rhs_count = x.GetColumnCount();
+
+    _refinement_report.iteration_count               = 0;
+    _refinement_report.condition_number_estimate     = 0.0;
+    _refinement_report.fell_back_to_double_precision = GL_FALSE;
+
+    if (!_float_lu_decomposition_is_done && size > 1) {
+        _float_lu.assign(_data.begin(), _data.end());
+        _float_row_permutation.resize(size);
+
+        _float_lu_decomposition_is_done = _DecomposeInPlace(
+            size, _float_lu.data(), _float_row_permutation.data());
+    }
+
+    Matrix<GLdouble> b(x);
+
+    if (_float_lu_decomposition_is_done) {
+        Matrix<GLfloat> correction(size, rhs_count);
+
+        // initial solution in single precision
+        for (GLuint i = 0; i < size; ++i)
+            for (GLuint k = 0; k < rhs_count; ++k)
+                correction(i, k) = (GLfloat)b(i, k);
+
+        LUFactorization::_SubstituteInPlace(
+            (GLint)size, _float_lu.data(), _float_row_permutation.data(),
+            correction.GetBlockView(), GL_TRUE);
+
+        for (GLuint i = 0; i < size; ++i)
+            for (GLuint k = 0; k < rhs_count; ++k)
+                x(i, k) = correction(i, k);
+
+        // infinity norm of the matrix
+        GLdouble matrix_norm = 0.0;
+        for (GLuint i = 0; i < size; ++i) {
+            GLdouble row_sum = 0.0;
+            for (GLuint j = 0; j < size; ++j)
+                row_sum += abs(_data[i * size + j]);
+            matrix_norm = max(matrix_norm, row_sum);
+        }
+
+        // the solution is accepted as soon as its residual is as small as the
+        // one of a backward stable double precision solver
+        const GLdouble tolerance = matrix_norm * DBL_EPSILON * sqrt((GLdouble)size);
+
+        GLint            row_count = (GLint)size;
+        vector<GLdouble> residual_norm_of_each_row(size);
+        GLdouble         previous_correction_norm = numeric_limits<GLdouble>::max();
+
+        for (GLuint iteration = 0;; ++iteration) {
+            // residual in double precision: r = b - A * x, it is rounded to
+            // single precision only after it has been computed
+#pragma omp parallel if (row_count >= _lu_parallel_threshold)
+            {
+                // residuals of the current row, allocated once per thread
+                vector<GLdouble> residual(rhs_count);
+
+#pragma omp for schedule(static)
+                for (GLint i = 0; i < row_count; ++i) {
+                    const GLdouble *row_a = &_data[i * size];
+                    const GLdouble *row_b = &b(i, 0);
+
+                    for (GLuint k = 0; k < rhs_count; ++k)
+                        residual[k] = row_b[k];
+
+                    for (GLuint j = 0; j < size; ++j) {
+                        const GLdouble  a_ij  = row_a[j];
+                        const GLdouble *row_x = &x(j, 0);
+                        for (GLuint k = 0; k < rhs_count; ++k)
+                            residual[k] -= a_ij * row_x[k];
+                    }
+
+                    GLdouble residual_norm = 0.0;
+                    for (GLuint k = 0; k < rhs_count; ++k) {
+                        correction(i, k) = (GLfloat)residual[k];
+                        residual_norm    = max(residual_norm, abs(residual[k]));
+                    }
+                    residual_norm_of_each_row[i] = residual_norm;
+                }
+            }
+
+            GLdouble residual_norm = 0.0, solution_norm = 0.0;
+            for (GLuint i = 0; i < size; ++i) {
+                residual_norm = max(residual_norm, residual_norm_of_each_row[i]);
+                for (GLuint k = 0; k < rhs_count; ++k)
+                    solution_norm = max(solution_norm, abs(x(i, k)));
+            }
+
+            _refinement_report.iteration_count = iteration;
+
+            // an overflowing solution cannot be refined
+            if (!isfinite(solution_norm))
+                break;
+
+            if (residual_norm <= tolerance * solution_norm)
+                return GL_TRUE;
+
+            if (iteration == _maximum_refinement_count)
+                break;
+
+            LUFactorization::_SubstituteInPlace(
+                (GLint)size, _float_lu.data(), _float_row_permutation.data(),
+                correction.GetBlockView(), GL_TRUE);
+
+            GLdouble correction_norm = 0.0;
+            for (GLuint i = 0; i < size; ++i)
+                for (GLuint k = 0; k < rhs_count; ++k) {
+                    x(i, k) += correction(i, k);
+                    correction_norm =
+                        max(correction_norm, (GLdouble)abs(correction(i, k)));
+                }
+
+            if (iteration == 0 && solution_norm > 0.0)
+                _refinement_report.condition_number_estimate =
+                    correction_norm / (solution_norm * FLT_EPSILON);
+
+            // the corrections do not decrease fast enough, i.e., the matrix is
+            // too ill-conditioned for single precision factors
+            if (correction_norm > 0.5 * previous_correction_norm)
+                break;
+
+            previous_correction_norm = correction_norm;
+        }
+    }
+
+    //--------------------------------------------------------------
+    // fall back to a double precision decomposition, which replaces
+    // the original elements, thus the single precision factors are
+    // no longer needed
+    //--------------------------------------------------------------
+    _refinement_report.fell_back_to_double_precision = GL_TRUE;
+
+    _float_lu_decomposition_is_done = GL_FALSE;
+    vector<GLfloat>().swap(_float_lu);
+    vector<GLuint>().swap(_float_row_permutation);
+
+    if (!PerformLUDecomposition())
+        return GL_FALSE;
+
+    x = b;
+
+    return LUFactorization::_SubstituteInPlace(
+        (GLint)size, _data.data(), _row_permutation.data(), x.GetBlockView(),
+        GL_TRUE);
+}
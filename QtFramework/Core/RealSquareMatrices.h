@@ -1,20 +1,275 @@
 #pragma once
 
+#include "DCoordinates3.h"
 #include "Matrices.h"
 #include <GL/glew.h>
+#include <algorithm>
 #include <cmath>
+#include <functional>
 #include <limits>
+#include <memory>
 
 namespace cagd {
+class RealSquareMatrix;
+class BandedSquareMatrix;
+
+//----------------------
+// class LUFactorization
+//----------------------
+// An immutable snapshot of the LU decomposition of a RealSquareMatrix or of a
+// BandedSquareMatrix. It is obtained by the GetLUFactorization() method of
+// these classes through a shared pointer to const, thus it can be shared among
+// threads and reused by independent solves: all methods are const and
+// reentrant.
+class LUFactorization
+{
+    friend class RealSquareMatrix;
+    friend class BandedSquareMatrix;
+
+protected:
+    GLuint                _size;
+    GLboolean             _is_banded;
+    GLuint                _lower_bandwidth; // only used if _is_banded
+    GLuint                _upper_bandwidth; // only used if _is_banded
+    std::vector<GLdouble> _lu;              // L and U factors, either dense
+                                            // row-major or in band storage
+    std::vector<GLuint>   _row_permutation; // row interchanges of pivoting
+
+    // dense factors
+    LUFactorization(GLuint size, const std::vector<GLdouble> &lu,
+                    const std::vector<GLuint> &row_permutation);
+
+    // banded factors, see BandedSquareMatrix for the storage scheme
+    LUFactorization(GLuint size, GLuint lower_bandwidth, GLuint upper_bandwidth,
+                    const std::vector<GLdouble> &lu,
+                    const std::vector<GLuint> &row_permutation);
+
+    // number of right-hand sides that are substituted together
+    static const GLuint _rhs_block_width = 32;
+
+    // forward and back substitution on the right-hand sides stored by x,
+    // shared by LUFactorization and RealSquareMatrix, the factors may be
+    // stored either in double (S = GLdouble) or in single (S = GLfloat)
+    // precision
+    template <class S, class T>
+    static GLboolean
+    _SubstituteInPlace(GLint size, const S *lu,
+                       const GLuint *row_permutation, const BlockView<T> &x,
+                       GLboolean represent_solutions_as_columns);
+
+    // banded counterpart of _SubstituteInPlace, shared by LUFactorization and
+    // BandedSquareMatrix
+    template <class T>
+    static GLboolean _SubstituteBandedInPlace(
+        GLint size, GLint lower_bandwidth, GLint upper_bandwidth,
+        const GLdouble *lu, const GLuint *row_permutation,
+        const BlockView<T> &x, GLboolean represent_solutions_as_columns);
+
+    // Substitutes a block of right-hand sides packed into a row-major
+    // size x width buffer, i.e., row i stores the i-th component of every
+    // right-hand side of the block contiguously. Thus the innermost loops are
+    // axpy operations over contiguous memory that the compiler can vectorize.
+    template <class S, class T>
+    static GLvoid _SubstituteBlock(GLint size, const S *lu,
+                                   const GLuint *row_permutation, GLuint width,
+                                   T *block);
+
+    // banded counterpart of _SubstituteBlock
+    template <class T>
+    static GLvoid _SubstituteBandedBlock(GLint size, GLint lower_bandwidth,
+                                         GLint upper_bandwidth,
+                                         const GLdouble *lu,
+                                         const GLuint *row_permutation,
+                                         GLuint width, T *block);
+
+    // checks whether the address ranges of the elements of two views intersect
+    template <class U, class T>
+    static GLboolean _ViewsOverlap(const BlockView<U> &b, const BlockView<T> &x);
+
+    // Copies the right-hand sides of b into x, whose dimensions have to agree,
+    // shared by RealSquareMatrix and BandedSquareMatrix. Nothing is copied if
+    // the views coincide, and overlapping views are copied through a
+    // temporary matrix, since writing x would overwrite elements of b that
+    // have not been read yet.
+    template <class U, class T>
+    static GLvoid _CopyRightHandSides(const BlockView<U> &b,
+                                      const BlockView<T> &x);
+
+    // determines the number of unknowns and right-hand sides stored by x,
+    // and the corresponding strides
+    template <class T>
+    static GLvoid _GetLayout(const BlockView<T> &x,
+                             GLboolean represent_solutions_as_columns,
+                             GLuint &unknown_count, GLuint &rhs_count,
+                             GLuint &unknown_stride, GLuint &rhs_stride);
+
+    // copies the right-hand sides [first, first + width) of data into the
+    // row-major size x width buffer block, and back
+    template <class T>
+    static GLvoid _Pack(GLint size, const T *data, GLuint unknown_stride,
+                        GLuint rhs_stride, GLuint first, GLuint width,
+                        T *block);
+    template <class T>
+    static GLvoid _Unpack(GLint size, const T *block, GLuint unknown_stride,
+                          GLuint rhs_stride, GLuint first, GLuint width,
+                          T *data);
+
+    // y[0..count) -= a * x[0..count), the ranges may not overlap, thus the
+    // loops over doubles and floats are vectorized without aliasing checks
+    template <class T>
+    static GLvoid _Axpy(GLuint count, GLdouble a, const T *x, T *y);
+    static GLvoid _Axpy(GLuint count, GLdouble a, const GLdouble *x,
+                        GLdouble *y);
+    static GLvoid _Axpy(GLuint count, GLdouble a, const GLfloat *x,
+                        GLfloat *y);
+    static GLvoid _Axpy(GLuint count, GLdouble a, const DCoordinate3 *x,
+                        DCoordinate3 *y);
+
+    // y[0..count) /= a
+    template <class T>
+    static GLvoid _Divide(GLuint count, GLdouble a, T *y);
+    static GLvoid _Divide(GLuint count, GLdouble a, GLdouble *y);
+    static GLvoid _Divide(GLuint count, GLdouble a, GLfloat *y);
+    static GLvoid _Divide(GLuint count, GLdouble a, DCoordinate3 *y);
+
+public:
+    // dimension of the factorized matrix
+    GLuint GetSize() const;
+
+    // whether the factors are stored in band form
+    GLboolean IsBanded() const;
+
+    // solves A * x = b with the factors of A, see
+    // RealSquareMatrix::SolveLinearSystem for the meaning of the parameters
+    template <class T>
+    GLboolean Solve(const Matrix<T> &b, Matrix<T> &x,
+                    GLboolean represent_solutions_as_columns = GL_TRUE) const;
+
+    // in-place variant: x stores the right-hand sides on input and the
+    // solutions on output
+    template <class T>
+    GLboolean Solve(const BlockView<T> &x,
+                    GLboolean represent_solutions_as_columns = GL_TRUE) const;
+};
+
+//-------------------------------------
+// template struct MixedPrecisionTraits
+//-------------------------------------
+// Describes how right-hand sides of type T are split into the double
+// precision components that the mixed precision mode of RealSquareMatrix
+// refines. Types without a specialization are solved in the precision of
+// the decomposition.
+template <class T>
+struct MixedPrecisionTraits
+{
+    static const GLuint component_count = 0;
+};
+
+template <>
+struct MixedPrecisionTraits<GLdouble>
+{
+    static const GLuint component_count = 1;
+
+    static GLdouble GetComponent(const GLdouble &value, GLuint)
+    {
+        return value;
+    }
+
+    static GLvoid SetComponent(GLdouble &value, GLuint, GLdouble component)
+    {
+        value = component;
+    }
+};
+
+// the solutions are rounded to single precision only after the refinement
+template <>
+struct MixedPrecisionTraits<GLfloat>
+{
+    static const GLuint component_count = 1;
+
+    static GLdouble GetComponent(const GLfloat &value, GLuint)
+    {
+        return value;
+    }
+
+    static GLvoid SetComponent(GLfloat &value, GLuint, GLdouble component)
+    {
+        value = (GLfloat)component;
+    }
+};
+
+template <>
+struct MixedPrecisionTraits<DCoordinate3>
+{
+    static const GLuint component_count = 3;
+
+    static GLdouble GetComponent(const DCoordinate3 &value, GLuint index)
+    {
+        return value[index];
+    }
+
+    static GLvoid SetComponent(DCoordinate3 &value, GLuint index,
+                               GLdouble component)
+    {
+        value[index] = component;
+    }
+};
+
+//-----------------------
+// class RealSquareMatrix
+//-----------------------
 class RealSquareMatrix : public Matrix<GLdouble>
 {
+public:
+    // statistics of the latest mixed precision solve
+    struct RefinementReport
+    {
+        GLuint    iteration_count;
+        // rough estimate of the infinity norm condition number, derived from
+        // the size of the first correction, which is about
+        // condition_number * FLT_EPSILON relative to the solution
+        GLdouble  condition_number_estimate;
+        // set if the refinement stalled or the single precision
+        // decomposition failed, and the system was solved in double precision
+        GLboolean fell_back_to_double_precision;
+    };
+
 private:
     GLboolean           _lu_decomposition_is_done;
     std::vector<GLuint> _row_permutation;
 
+    // opt-in mixed precision mode: the matrix is factorized in single
+    // precision, while the residuals and the solutions are refined in double
+    // precision, hence the original elements are kept until the mode falls
+    // back to a double precision decomposition
+    GLboolean            _mixed_precision_is_enabled;
+    GLuint               _maximum_refinement_count;
+    GLboolean            _float_lu_decomposition_is_done;
+    std::vector<GLfloat> _float_lu;
+    std::vector<GLuint>  _float_row_permutation;
+    RefinementReport     _refinement_report;
+
+    // tuning parameters of the blocked LU decomposition: number of columns
+    // factorized together, number of trailing columns updated at once (so
+    // that the involved part of the panel rows stays in cache), and the
+    // minimal number of trailing rows for which the update is multithreaded
+    static const GLuint _lu_panel_width        = 64;
+    static const GLuint _lu_column_block_width = 512;
+    static const GLint  _lu_parallel_threshold = 128;
+
 
     void _copy(const RealSquareMatrix &m);
 
+    // LU decomposition of the row-major size x size matrix stored by data,
+    // performed in the precision of S
+    template <class S>
+    static GLboolean _DecomposeInPlace(GLuint size, S *data,
+                                       GLuint *row_permutation);
+
+    // mixed precision solver: on input the columns of x store the right-hand
+    // sides, on output the solutions
+    GLboolean _SolveInMixedPrecision(Matrix<GLdouble> &x);
+
 public:
     // special/default constructor
     RealSquareMatrix(GLuint size = 1);
@@ -22,9 +277,15 @@ public:
     // copy constructor
     RealSquareMatrix(const RealSquareMatrix &m);
 
+    // move constructor
+    RealSquareMatrix(RealSquareMatrix &&m) noexcept;
+
     // assignment operator
     RealSquareMatrix &operator=(const RealSquareMatrix &rhs);
 
+    // move assignment operator
+    RealSquareMatrix &operator=(RealSquareMatrix &&rhs) noexcept;
+
     // square matrices have the same number of rows and columns!
     GLboolean ResizeRows(GLuint row_count);
     GLboolean ResizeColumns(GLuint row_count);
@@ -32,6 +293,26 @@ public:
     // tries to determine the LU decomposition of this square matrix
     GLboolean PerformLUDecomposition();
 
+    // performs the LU decomposition if needed and returns an immutable copy of
+    // the factors that can outlive this matrix, or a null pointer if the
+    // matrix is singular
+    std::shared_ptr<const LUFactorization> GetLUFactorization();
+
+    // Enables or disables the mixed precision mode of SolveLinearSystem: the
+    // matrix is factorized in single precision, which is faster and whose
+    // factors need half of the memory, and the solutions are improved by at most
+    // maximum_refinement_count steps of iterative refinement in double
+    // precision. If the refinement stalls, the matrix is factorized in double
+    // precision. The mode applies to right-hand sides of type GLdouble,
+    // GLfloat or DCoordinate3 (see MixedPrecisionTraits), and only until a
+    // double precision decomposition is performed.
+    GLvoid SetMixedPrecision(GLboolean enabled,
+                             GLuint    maximum_refinement_count = 10);
+    GLboolean IsMixedPrecisionEnabled() const;
+
+    // statistics of the latest mixed precision solve
+    const RefinementReport &GetRefinementReport() const;
+
     // Solves linear systems of type A * x = b, where A is a regular square
     // matrix, while b and x are row or column matrices with elements of type T.
     // Here matrix A corresponds to *this.
@@ -41,6 +322,22 @@ public:
     GLboolean
     SolveLinearSystem(const Matrix<T> &b, Matrix<T> &x,
                       GLboolean represent_solutions_as_columns = GL_TRUE);
+
+    // Same as above, but b and x are views, e.g., blocks, rows or columns of
+    // larger matrices. The dimensions of b and x have to agree, x is not
+    // resized. If b and x are the same view, the system is solved in place,
+    // if they overlap otherwise, b is copied through a temporary matrix.
+    template <class U, class T>
+    GLboolean
+    SolveLinearSystem(const BlockView<U> &b, const BlockView<T> &x,
+                      GLboolean represent_solutions_as_columns = GL_TRUE);
+
+    // In-place variant: on input x stores the right-hand sides, on output it
+    // stores the solutions.
+    template <class T>
+    GLboolean
+    SolveLinearSystem(const BlockView<T> &x,
+                      GLboolean represent_solutions_as_columns = GL_TRUE);
 };
 
 template <class T>
@@ -48,69 +345,467 @@ GLboolean
 RealSquareMatrix::SolveLinearSystem(const Matrix<T> &b, Matrix<T> &x,
                                     GLboolean represent_solutions_as_columns)
 {
-    if (!_lu_decomposition_is_done)
-        if (!PerformLUDecomposition())
+    if (represent_solutions_as_columns) {
+        if (b.GetRowCount() != GetColumnCount())
+            return GL_FALSE;
+    } else {
+        if (b.GetColumnCount() != GetRowCount())
             return GL_FALSE;
+    }
 
-    if (represent_solutions_as_columns) {
-        GLint size = GetColumnCount();
-        if ((GLint)b.GetRowCount() != size)
+    x = b;
+
+    return SolveLinearSystem(x.GetBlockView(), represent_solutions_as_columns);
+}
+
+template <class U, class T>
+GLboolean
+RealSquareMatrix::SolveLinearSystem(const BlockView<U> &b, const BlockView<T> &x,
+                                    GLboolean represent_solutions_as_columns)
+{
+    if (b.GetRowCount() != x.GetRowCount() ||
+        b.GetColumnCount() != x.GetColumnCount())
+        return GL_FALSE;
+
+    LUFactorization::_CopyRightHandSides(b, x);
+
+    return SolveLinearSystem(x, represent_solutions_as_columns);
+}
+
+template <class U, class T>
+GLvoid LUFactorization::_CopyRightHandSides(const BlockView<U> &b,
+                                            const BlockView<T> &x)
+{
+    // the element types may differ, thus the addresses are compared as such
+    if ((const void *)b.GetData() == (const void *)x.GetData() &&
+        b.GetRowStride() == x.GetRowStride() &&
+        b.GetColumnStride() == x.GetColumnStride())
+        return;
+
+    if (_ViewsOverlap(b, x)) {
+        Matrix<T> temporary(b.GetRowCount(), b.GetColumnCount());
+
+        for (GLuint i = 0; i < b.GetRowCount(); ++i)
+            for (GLuint j = 0; j < b.GetColumnCount(); ++j)
+                temporary(i, j) = b(i, j);
+
+        for (GLuint i = 0; i < b.GetRowCount(); ++i)
+            for (GLuint j = 0; j < b.GetColumnCount(); ++j)
+                x(i, j) = temporary(i, j);
+    } else {
+        for (GLuint i = 0; i < b.GetRowCount(); ++i)
+            for (GLuint j = 0; j < b.GetColumnCount(); ++j)
+                x(i, j) = b(i, j);
+    }
+}
+
+// Only the address ranges are compared, thus views that interleave without
+// sharing elements (e.g., two columns of a matrix) are also reported as
+// overlapping, which costs just an unnecessary copy.
+template <class U, class T>
+GLboolean LUFactorization::_ViewsOverlap(const BlockView<U> &b,
+                                         const BlockView<T> &x)
+{
+    if (!b.GetRowCount() || !b.GetColumnCount() || !x.GetRowCount() ||
+        !x.GetColumnCount())
+        return GL_FALSE;
+
+    const void *b_first = b.GetData();
+    const void *b_last  = &b(b.GetRowCount() - 1, b.GetColumnCount() - 1);
+    const void *x_first = x.GetData();
+    const void *x_last  = &x(x.GetRowCount() - 1, x.GetColumnCount() - 1);
+
+    // the views are unrelated in general, thus their addresses are compared
+    // by std::less, which is a total order
+    std::less<const void *> less;
+
+    return !less(b_last, x_first) && !less(x_last, b_first);
+}
+
+template <class T>
+GLboolean
+RealSquareMatrix::SolveLinearSystem(const BlockView<T> &x,
+                                    GLboolean represent_solutions_as_columns)
+{
+    typedef MixedPrecisionTraits<T> Traits;
+
+    if (_mixed_precision_is_enabled && !_lu_decomposition_is_done &&
+        Traits::component_count) {
+        GLuint unknown_count, rhs_count, unknown_stride, rhs_stride;
+        LUFactorization::_GetLayout(x, represent_solutions_as_columns,
+                                    unknown_count, rhs_count, unknown_stride,
+                                    rhs_stride);
+
+        if (unknown_count != _row_count)
             return GL_FALSE;
 
-        x = b;
-
-        for (GLuint k = 0; k < b.GetColumnCount(); ++k) {
-            GLint ii = 0;
-            for (GLint i = 0; i < size; ++i) {
-                GLuint ip  = _row_permutation[i];
-                T      sum = x(ip, k);
-                x(ip, k)   = x(i, k);
-                if (ii != 0)
-                    for (GLint j = ii - 1; j < i; ++j)
-                        sum -= _data[i][j] * x(j, k);
-                else if (sum != 0.0)
-                    ii = i + 1;
-                x(i, k) = sum;
+        // the components of the right-hand sides are gathered into the
+        // columns of a double precision matrix
+        const GLuint     component_count = Traits::component_count;
+        Matrix<GLdouble> components(unknown_count, rhs_count * component_count);
+        T *              data = x.GetData();
+
+        for (GLuint i = 0; i < unknown_count; ++i)
+            for (GLuint k = 0; k < rhs_count; ++k) {
+                const T &element = data[i * unknown_stride + k * rhs_stride];
+                for (GLuint c = 0; c < component_count; ++c)
+                    components(i, k * component_count + c) =
+                        Traits::GetComponent(element, c);
             }
 
-            for (GLint i = size - 1; i >= 0; --i) {
-                T sum = x(i, k);
-                for (GLint j = i + 1; j < size; ++j)
-                    sum -= _data[i][j] * x(j, k);
-                x(i, k) = sum /= _data[i][i];
+        if (!_SolveInMixedPrecision(components))
+            return GL_FALSE;
+
+        for (GLuint i = 0; i < unknown_count; ++i)
+            for (GLuint k = 0; k < rhs_count; ++k) {
+                T &element = data[i * unknown_stride + k * rhs_stride];
+                for (GLuint c = 0; c < component_count; ++c)
+                    Traits::SetComponent(element, c,
+                                         components(i, k * component_count + c));
             }
-        }
+
+        return GL_TRUE;
+    }
+
+    if (!_lu_decomposition_is_done)
+        if (!PerformLUDecomposition())
+            return GL_FALSE;
+
+    return LUFactorization::_SubstituteInPlace(
+        (GLint)GetRowCount(), _data.data(), _row_permutation.data(), x,
+        represent_solutions_as_columns);
+}
+
+//---------------------------------------------------------
+// implementation of the template methods of LUFactorization
+//---------------------------------------------------------
+template <class T>
+GLboolean LUFactorization::Solve(const Matrix<T> &b, Matrix<T> &x,
+                                 GLboolean represent_solutions_as_columns) const
+{
+    if (represent_solutions_as_columns) {
+        if (b.GetRowCount() != _size)
+            return GL_FALSE;
     } else {
-        GLint size = GetRowCount();
-        if ((GLint)b.GetColumnCount() != size)
+        if (b.GetColumnCount() != _size)
             return GL_FALSE;
+    }
 
-        x = b;
-
-        for (GLuint k = 0; k < b.GetRowCount(); ++k) {
-            GLint ii = 0;
-            for (GLint i = 0; i < size; ++i) {
-                GLuint ip  = _row_permutation[i];
-                T      sum = x(k, ip);
-                x(k, ip)   = x(k, i);
-                if (ii != 0)
-                    for (GLint j = ii - 1; j < i; ++j)
-                        sum -= _data[i][j] * x(k, j);
-                else if (sum != 0.0)
-                    ii = i + 1;
-                x(k, i) = sum;
-            }
+    x = b;
 
-            for (GLint i = size - 1; i >= 0; --i) {
-                T sum = x(k, i);
-                for (GLint j = i + 1; j < size; ++j)
-                    sum -= _data[i][j] * x(k, j);
-                x(k, i) = sum /= _data[i][i];
-            }
-        }
+    return Solve(x.GetBlockView(), represent_solutions_as_columns);
+}
+
+template <class T>
+GLboolean LUFactorization::Solve(const BlockView<T> &x,
+                                 GLboolean represent_solutions_as_columns) const
+{
+    if (_is_banded)
+        return _SubstituteBandedInPlace(
+            (GLint)_size, (GLint)_lower_bandwidth, (GLint)_upper_bandwidth,
+            _lu.data(), _row_permutation.data(), x,
+            represent_solutions_as_columns);
+
+    return _SubstituteInPlace((GLint)_size, _lu.data(), _row_permutation.data(),
+                              x, represent_solutions_as_columns);
+}
+
+template <class T>
+GLvoid LUFactorization::_GetLayout(const BlockView<T> &x,
+                                   GLboolean represent_solutions_as_columns,
+                                   GLuint &unknown_count, GLuint &rhs_count,
+                                   GLuint &unknown_stride, GLuint &rhs_stride)
+{
+    // the unknowns run along the rows of x if the solutions are represented
+    // as columns, and along the columns of x otherwise
+    if (represent_solutions_as_columns) {
+        unknown_count  = x.GetRowCount();
+        rhs_count      = x.GetColumnCount();
+        unknown_stride = x.GetRowStride();
+        rhs_stride     = x.GetColumnStride();
+    } else {
+        unknown_count  = x.GetColumnCount();
+        rhs_count      = x.GetRowCount();
+        unknown_stride = x.GetColumnStride();
+        rhs_stride     = x.GetRowStride();
+    }
+}
+
+template <class T>
+inline GLvoid LUFactorization::_Pack(GLint size, const T *data,
+                                     GLuint unknown_stride, GLuint rhs_stride,
+                                     GLuint first, GLuint width, T *block)
+{
+    for (GLint i = 0; i < size; ++i)
+        for (GLuint k = 0; k < width; ++k)
+            block[i * width + k] =
+                data[i * unknown_stride + (first + k) * rhs_stride];
+}
+
+template <class T>
+inline GLvoid LUFactorization::_Unpack(GLint size, const T *block,
+                                       GLuint unknown_stride, GLuint rhs_stride,
+                                       GLuint first, GLuint width, T *data)
+{
+    for (GLint i = 0; i < size; ++i)
+        for (GLuint k = 0; k < width; ++k)
+            data[i * unknown_stride + (first + k) * rhs_stride] =
+                block[i * width + k];
+}
+
+template <class S, class T>
+GLboolean LUFactorization::_SubstituteInPlace(
+    GLint size, const S *lu, const GLuint *row_permutation,
+    const BlockView<T> &x, GLboolean represent_solutions_as_columns)
+{
+    GLuint unknown_count, rhs_count, unknown_stride, rhs_stride;
+    _GetLayout(x, represent_solutions_as_columns, unknown_count, rhs_count,
+               unknown_stride, rhs_stride);
+
+    if ((GLint)unknown_count != size)
+        return GL_FALSE;
+
+    T *     data        = x.GetData();
+    GLint   block_count = (GLint)((rhs_count + _rhs_block_width - 1) /
+                                _rhs_block_width);
+
+    // a single block is substituted outside of a parallel region, since
+    // entering one costs more than the substitution of a small system, even
+    // if its if clause is false
+    if (block_count == 1) {
+        std::vector<T> block(size * rhs_count);
+        _Pack(size, data, unknown_stride, rhs_stride, 0, rhs_count,
+              block.data());
+        _SubstituteBlock(size, lu, row_permutation, rhs_count, block.data());
+        _Unpack(size, block.data(), unknown_stride, rhs_stride, 0, rhs_count,
+                data);
+
+        return GL_TRUE;
+    }
+
+    // blocks of right-hand sides are independent of each other
+#pragma omp parallel for schedule(dynamic) if (size >= 64)
+    for (GLint b = 0; b < block_count; ++b) {
+        GLuint first = b * _rhs_block_width;
+        GLuint width = std::min(_rhs_block_width, rhs_count - first);
+
+        std::vector<T> block(size * width);
+        _Pack(size, data, unknown_stride, rhs_stride, first, width,
+              block.data());
+        _SubstituteBlock(size, lu, row_permutation, width, block.data());
+        _Unpack(size, block.data(), unknown_stride, rhs_stride, first, width,
+                data);
     }
 
     return GL_TRUE;
 }
 
+template <class T>
+GLboolean LUFactorization::_SubstituteBandedInPlace(
+    GLint size, GLint lower_bandwidth, GLint upper_bandwidth,
+    const GLdouble *lu, const GLuint *row_permutation, const BlockView<T> &x,
+    GLboolean represent_solutions_as_columns)
+{
+    GLuint unknown_count, rhs_count, unknown_stride, rhs_stride;
+    _GetLayout(x, represent_solutions_as_columns, unknown_count, rhs_count,
+               unknown_stride, rhs_stride);
+
+    if ((GLint)unknown_count != size)
+        return GL_FALSE;
+
+    T *     data        = x.GetData();
+    GLint   block_count = (GLint)((rhs_count + _rhs_block_width - 1) /
+                                _rhs_block_width);
+
+    // see _SubstituteInPlace
+    if (block_count == 1) {
+        std::vector<T> block(size * rhs_count);
+        _Pack(size, data, unknown_stride, rhs_stride, 0, rhs_count,
+              block.data());
+        _SubstituteBandedBlock(size, lower_bandwidth, upper_bandwidth, lu,
+                               row_permutation, rhs_count, block.data());
+        _Unpack(size, block.data(), unknown_stride, rhs_stride, 0, rhs_count,
+                data);
+
+        return GL_TRUE;
+    }
+
+#pragma omp parallel for schedule(dynamic) if (size >= 256)
+    for (GLint b = 0; b < block_count; ++b) {
+        GLuint first = b * _rhs_block_width;
+        GLuint width = std::min(_rhs_block_width, rhs_count - first);
+
+        std::vector<T> block(size * width);
+        _Pack(size, data, unknown_stride, rhs_stride, first, width,
+              block.data());
+        _SubstituteBandedBlock(size, lower_bandwidth, upper_bandwidth, lu,
+                               row_permutation, width, block.data());
+        _Unpack(size, block.data(), unknown_stride, rhs_stride, first, width,
+                data);
+    }
+
+    return GL_TRUE;
+}
+
+template <class S, class T>
+GLvoid LUFactorization::_SubstituteBlock(GLint size, const S *lu,
+                                         const GLuint *row_permutation,
+                                         GLuint width, T *block)
+{
+    // row interchanges, in the same order as they were performed during the
+    // decomposition
+    for (GLint i = 0; i < size; ++i) {
+        GLuint ip = row_permutation[i];
+        if ((GLint)ip != i)
+            std::swap_ranges(block + i * width, block + (i + 1) * width,
+                             block + ip * width);
+    }
+
+    // A single right-hand side is substituted by dot products, whose partial
+    // sums stay in registers, while an axpy of length 1 would store and
+    // reload its element after every step. The order of the operations is
+    // the same, only GLfloat right-hand sides of double precision factors
+    // are multiplied in double precision.
+    if (width == 1) {
+        for (GLint i = 1; i < size; ++i) {
+            T sum = block[i];
+            for (GLint j = 0; j < i; ++j)
+                sum -= lu[i * size + j] * block[j];
+            block[i] = sum;
+        }
+
+        for (GLint i = size - 1; i >= 0; --i) {
+            T sum = block[i];
+            for (GLint j = i + 1; j < size; ++j)
+                sum -= lu[i * size + j] * block[j];
+            _Divide(1, lu[i * size + i], &sum);
+            block[i] = sum;
+        }
+
+        return;
+    }
+
+    // forward substitution with the unit lower triangular factor
+    for (GLint i = 1; i < size; ++i) {
+        T *row_i = block + i * width;
+        for (GLint j = 0; j < i; ++j)
+            _Axpy(width, lu[i * size + j], block + j * width, row_i);
+    }
+
+    // back substitution with the upper triangular factor
+    for (GLint i = size - 1; i >= 0; --i) {
+        T *row_i = block + i * width;
+        for (GLint j = i + 1; j < size; ++j)
+            _Axpy(width, lu[i * size + j], block + j * width, row_i);
+        _Divide(width, lu[i * size + i], row_i);
+    }
+}
+
+template <class T>
+GLvoid LUFactorization::_SubstituteBandedBlock(GLint size, GLint lower_bandwidth,
+                                               GLint upper_bandwidth,
+                                               const GLdouble *lu,
+                                               const GLuint *row_permutation,
+                                               GLuint width, T *block)
+{
+    // row i of the band storage holds the columns
+    // [i - lower_bandwidth, i + lower_bandwidth + upper_bandwidth]
+    const GLint band_width = 2 * lower_bandwidth + upper_bandwidth + 1;
+
+    // forward substitution: the row interchanges and the eliminations are
+    // applied in the same order as they were performed during the
+    // decomposition, since the multipliers were not interchanged afterwards
+    for (GLint k = 0; k < size; ++k) {
+        T *    row_k = block + k * width;
+        GLuint kp    = row_permutation[k];
+        if ((GLint)kp != k)
+            std::swap_ranges(row_k, row_k + width, block + kp * width);
+
+        GLint last = std::min(k + lower_bandwidth, size - 1);
+        for (GLint i = k + 1; i <= last; ++i)
+            _Axpy(width, lu[i * band_width + k - i + lower_bandwidth], row_k,
+                  block + i * width);
+    }
+
+    // back substitution with the upper triangular factor, whose bandwidth
+    // grew by lower_bandwidth due to pivoting
+    for (GLint i = size - 1; i >= 0; --i) {
+        T *            row_i = block + i * width;
+        const GLdouble *lu_i = lu + i * band_width + lower_bandwidth - i;
+        GLint last = std::min(i + lower_bandwidth + upper_bandwidth, size - 1);
+
+        for (GLint j = i + 1; j <= last; ++j)
+            _Axpy(width, lu_i[j], block + j * width, row_i);
+        _Divide(width, lu_i[i], row_i);
+    }
+}
+
+template <class T>
+inline GLvoid LUFactorization::_Axpy(GLuint count, GLdouble a, const T *x,
+                                     T *y)
+{
+    for (GLuint k = 0; k < count; ++k)
+        y[k] -= a * x[k];
+}
+
+inline GLvoid LUFactorization::_Axpy(GLuint count, GLdouble a,
+                                     const GLdouble *x, GLdouble *y)
+{
+#pragma omp simd
+    for (GLuint k = 0; k < count; ++k)
+        y[k] -= a * x[k];
+}
+
+inline GLvoid LUFactorization::_Axpy(GLuint count, GLdouble a,
+                                     const GLfloat *x, GLfloat *y)
+{
+    const GLfloat af = (GLfloat)a;
+
+#pragma omp simd
+    for (GLuint k = 0; k < count; ++k)
+        y[k] -= af * x[k];
+}
+
+inline GLvoid LUFactorization::_Axpy(GLuint count, GLdouble a,
+                                     const DCoordinate3 *x, DCoordinate3 *y)
+{
+    // DCoordinate3 consists of doubles only (including the optional padding),
+    // hence a block of coordinates is a contiguous array of doubles
+    const GLuint    stride = sizeof(DCoordinate3) / sizeof(GLdouble);
+    const GLdouble *xd     = reinterpret_cast<const GLdouble *>(x);
+    GLdouble *      yd     = reinterpret_cast<GLdouble *>(y);
+
+    _Axpy(count * stride, a, xd, yd);
+}
+
+template <class T>
+inline GLvoid LUFactorization::_Divide(GLuint count, GLdouble a, T *y)
+{
+    for (GLuint k = 0; k < count; ++k)
+        y[k] /= a;
+}
+
+inline GLvoid LUFactorization::_Divide(GLuint count, GLdouble a, GLdouble *y)
+{
+    for (GLuint k = 0; k < count; ++k)
+        y[k] /= a;
+}
+
+inline GLvoid LUFactorization::_Divide(GLuint count, GLdouble a, GLfloat *y)
+{
+    const GLfloat af = (GLfloat)a;
+
+    for (GLuint k = 0; k < count; ++k)
+        y[k] /= af;
+}
+
+inline GLvoid LUFactorization::_Divide(GLuint count, GLdouble a,
+                                       DCoordinate3 *y)
+{
+    const GLuint stride = sizeof(DCoordinate3) / sizeof(GLdouble);
+    GLdouble *   yd     = reinterpret_cast<GLdouble *>(y);
+
+    _Divide(count * stride, a, yd);
+}
+
 } // namespace cagd
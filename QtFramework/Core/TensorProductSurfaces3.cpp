@@ -1,4 +1,6 @@
 #include "TensorProductSurfaces3.h"
+#include "BandedSquareMatrices.h"
+#include "CoordinateArrays3.h"
 #include "RealSquareMatrices.h"
 
 using namespace cagd;
@@ -45,6 +47,10 @@ TriangulatedMesh3 *TensorProductSurface3::GenerateImage(
     // partial derivatives of order 0, 1, 2, and 3
     PartialDerivatives pd;
 
+    // first order partial derivatives, the unit normals are calculated from
+    // them by batch kernels, in double precision
+    DCoordinateArray3 du_partials(vertex_count), dv_partials(vertex_count);
+
     for (GLuint i = 0; i < u_div_point_count; ++i) {
         GLdouble u = _u_min + i * du;
         GLfloat  s = i * sdu;
@@ -68,12 +74,10 @@ TriangulatedMesh3 *TensorProductSurface3::GenerateImage(
             CalculatePartialDerivatives(1, u, v, pd);
 
             // surface point
-            (*result)._vertex[index[0]] = pd(0, 0);
+            (*result)._vertex[index[0]] = FCoordinate3(pd(0, 0));
 
-            // unit surface normal
-            (*result)._normal[index[0]] = pd(1, 0);
-            (*result)._normal[index[0]] ^= pd(1, 1);
-            (*result)._normal[index[0]].normalize();
+            du_partials.Set(index[0], pd(1, 0));
+            dv_partials.Set(index[0], pd(1, 1));
 
             // texture coordinates
             (*result)._tex[index[0]].s() = s;
@@ -94,6 +98,11 @@ TriangulatedMesh3 *TensorProductSurface3::GenerateImage(
         }
     }
 
+    // unit surface normals
+    CrossAll(du_partials, dv_partials, du_partials);
+    NormalizeAll(du_partials);
+    du_partials.Scatter(&(*result)._normal[0]);
+
     return result;
 }
 
@@ -118,32 +127,57 @@ GLboolean TensorProductSurface3::UpdateDataForInterpolation(
         return GL_FALSE;
 
     // 1: calculate the u-collocation matrix and perfom LU-decomposition on it
-    RowMatrix<GLdouble> u_blending_values;
+    //    (unless it is cached for the same knot vector), the band structure of
+    //    locally supported bases is exploited automatically
+    if (!_u_interpolation_factorization ||
+        _u_interpolation_knot_vector != u_knot_vector) {
+        _u_interpolation_factorization.reset();
+
+        RowMatrix<GLdouble> u_blending_values;
+
+        RealSquareMatrix u_collocation_matrix(row_count);
 
-    RealSquareMatrix u_collocation_matrix(row_count);
+        for (GLuint i = 0; i < row_count; ++i) {
+            if (!UBlendingFunctionValues(u_knot_vector(i),
+                                         u_blending_values) ||
+                !u_collocation_matrix.SetRow(i, u_blending_values))
+                return GL_FALSE;
+        }
 
-    for (GLuint i = 0; i < row_count; ++i) {
-        if (!UBlendingFunctionValues(u_knot_vector(i), u_blending_values))
+        _u_interpolation_factorization =
+            BandedSquareMatrix::FactorizeAutomatically(u_collocation_matrix);
+
+        if (!_u_interpolation_factorization)
             return GL_FALSE;
-        u_collocation_matrix.SetRow(i, u_blending_values);
-    }
 
-    if (!u_collocation_matrix.PerformLUDecomposition())
-        return GL_FALSE;
+        _u_interpolation_knot_vector = u_knot_vector;
+    }
 
     // 2: calculate the v-collocation matrix and perform LU-decomposition on it
-    RowMatrix<GLdouble> v_blending_values;
+    //    (unless it is cached for the same knot vector)
+    if (!_v_interpolation_factorization ||
+        _v_interpolation_knot_vector != v_knot_vector) {
+        _v_interpolation_factorization.reset();
+
+        RowMatrix<GLdouble> v_blending_values;
+
+        RealSquareMatrix v_collocation_matrix(column_count);
 
-    RealSquareMatrix v_collocation_matrix(column_count);
+        for (GLuint j = 0; j < column_count; ++j) {
+            if (!VBlendingFunctionValues(v_knot_vector(j),
+                                         v_blending_values) ||
+                !v_collocation_matrix.SetRow(j, v_blending_values))
+                return GL_FALSE;
+        }
+
+        _v_interpolation_factorization =
+            BandedSquareMatrix::FactorizeAutomatically(v_collocation_matrix);
 
-    for (GLuint j = 0; j < column_count; ++j) {
-        if (!VBlendingFunctionValues(v_knot_vector(j), v_blending_values))
+        if (!_v_interpolation_factorization)
             return GL_FALSE;
-        v_collocation_matrix.SetRow(j, v_blending_values);
-    }
 
-    if (!v_collocation_matrix.PerformLUDecomposition())
-        return GL_FALSE;
+        _v_interpolation_knot_vector = v_knot_vector;
+    }
 
     // 3:   for all fixed j in {0, 1,..., column_count} determine control points
     //
@@ -157,7 +191,7 @@ GLboolean TensorProductSurface3::UpdateDataForInterpolation(
     //
     //      for all i = 0, 1,..., row_count.
     Matrix<DCoordinate3> a(row_count, column_count);
-    if (!u_collocation_matrix.SolveLinearSystem(data_points_to_interpolate, a))
+    if (!_u_interpolation_factorization->Solve(data_points_to_interpolate, a))
         return GL_FALSE;
 
     // 4:   for all fixed i in {0, 1,..., row_count} determine control point
@@ -169,7 +203,7 @@ GLboolean TensorProductSurface3::UpdateDataForInterpolation(
     //      sum_{l=0}^{column_count} _data(i, l) G_l(v_j) = a_i(v_j)
     //
     //      for all j = 0, 1,..., column_count.
-    if (!v_collocation_matrix.SolveLinearSystem(a, _data, GL_FALSE))
+    if (!_v_interpolation_factorization->Solve(a, _data, GL_FALSE))
         return GL_FALSE;
 
     return GL_TRUE;
@@ -185,10 +219,7 @@ GLboolean TensorProductSurface3::UpdateDataForInterpolation(
 // --------------------
 GLvoid TensorProductSurface3::PartialDerivatives::LoadNullVectors()
 {
-    for_each(_data.begin(), _data.end(), [](std::vector<DCoordinate3> &row) {
-        for_each(row.begin(), row.end(),
-                 [](DCoordinate3 &coord) { coord = DCoordinate3(); });
-    });
+    fill(_data.begin(), _data.end(), DCoordinate3());
 }
 
 
@@ -231,6 +262,10 @@ TensorProductSurface3::TensorProductSurface3(
     , _v_min(surface._v_min)
     , _v_max(surface._v_max)
     , _data(surface._data)
+    , _u_interpolation_knot_vector(surface._u_interpolation_knot_vector)
+    , _u_interpolation_factorization(surface._u_interpolation_factorization)
+    , _v_interpolation_knot_vector(surface._v_interpolation_knot_vector)
+    , _v_interpolation_factorization(surface._v_interpolation_factorization)
 {}
 
 TensorProductSurface3 &TensorProductSurface3::
@@ -245,6 +280,11 @@ TensorProductSurface3 &TensorProductSurface3::
     _data     = surface._data;
     _vbo_data = 0;
 
+    _u_interpolation_knot_vector   = surface._u_interpolation_knot_vector;
+    _u_interpolation_factorization = surface._u_interpolation_factorization;
+    _v_interpolation_knot_vector   = surface._v_interpolation_knot_vector;
+    _v_interpolation_factorization = surface._v_interpolation_factorization;
+
     return *this;
 }
 
@@ -253,12 +293,18 @@ GLvoid TensorProductSurface3::SetUInterval(GLdouble u_min, GLdouble u_max)
 {
     _u_min = u_min;
     _u_max = u_max;
+
+    // the blending functions may depend on the definition domain
+    _u_interpolation_factorization.reset();
 }
 
 GLvoid TensorProductSurface3::SetVInterval(GLdouble v_min, GLdouble v_max)
 {
     _v_min = v_min;
     _v_max = v_max;
+
+    // the blending functions may depend on the definition domain
+    _v_interpolation_factorization.reset();
 }
 
 GLvoid TensorProductSurface3::GetUInterval(GLdouble &u_min,
@@ -408,23 +454,16 @@ TensorProductSurface3::UpdateVertexBufferObjectsOfData(GLenum usage_flag)
         return GL_FALSE;
     }
 
-    for (GLuint i = 0; i < row_count; ++i) {
-        for (GLuint j = 0; j < col_count; ++j) {
-            for (GLuint k = 0; k < 3; ++k) {
-                *coordinate = (GLfloat)_data(i, j)[k];
-                ++coordinate;
-            }
-        }
-    }
+    // the buffer is an array of tightly packed single precision coordinates
+    FCoordinate3 *point = reinterpret_cast<FCoordinate3 *>(coordinate);
 
-    for (GLuint j = 0; j < col_count; ++j) {
-        for (GLuint i = 0; i < row_count; ++i) {
-            for (GLuint k = 0; k < 3; ++k) {
-                *coordinate = (GLfloat)_data(i, j)[k];
-                ++coordinate;
-            }
-        }
-    }
+    for (GLuint i = 0; i < row_count; ++i)
+        for (GLuint j = 0; j < col_count; ++j)
+            *point++ = FCoordinate3(_data(i, j));
+
+    for (GLuint j = 0; j < col_count; ++j)
+        for (GLuint i = 0; i < row_count; ++i)
+            *point++ = FCoordinate3(_data(i, j));
 
     if (!glUnmapBuffer(GL_ARRAY_BUFFER)) {
         glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -449,6 +488,9 @@ RowMatrix<GenericCurve3 *> *TensorProductSurface3::GenerateUIsoparametricLines(
     const GLdouble u_delta = (_u_max - _u_min) / (div_point_count - 1);
     const GLdouble v_delta = (_v_max - _v_min) / (iso_line_count - 1);
     GLdouble       v_iter  = _v_min;
+
+    // reused by every sample, CalculatePartialDerivatives only overwrites it
+    PartialDerivatives partial_derivatives(maximum_order_of_derivatives);
     for (GLuint count = 0; count < iso_line_count; ++count, v_iter += v_delta) {
         GLdouble       u_iter        = _u_min;
         GenericCurve3 *current_curve = new GenericCurve3(
@@ -456,7 +498,6 @@ RowMatrix<GenericCurve3 *> *TensorProductSurface3::GenerateUIsoparametricLines(
 
         for (GLuint u_count = 0; u_count < div_point_count;
              ++u_count, u_iter += u_delta) {
-            PartialDerivatives partial_derivatives(div_point_count);
             if (!CalculatePartialDerivatives(
                     maximum_order_of_derivatives, min(_u_max, u_iter),
                     min(v_iter, _v_max), partial_derivatives)) {
@@ -489,6 +530,10 @@ RowMatrix<GenericCurve3 *> *TensorProductSurface3::GenerateVIsoparametricLines(
     const GLdouble u_delta = (_u_max - _u_min) / (iso_line_count - 1);
     GLdouble       u_iter  = _u_min;
     const GLdouble v_delta = (_v_max - _v_min) / (div_point_count - 1);
+
+    // reused by every sample, CalculatePartialDerivatives only overwrites it
+    PartialDerivatives partial_derivatives(maximum_order_of_derivatives);
+
     for (GLuint count = 0; count < iso_line_count; ++count, u_iter += u_delta) {
         GLdouble       v_iter        = _v_min;
         GenericCurve3 *current_curve = new GenericCurve3(
@@ -496,7 +541,6 @@ RowMatrix<GenericCurve3 *> *TensorProductSurface3::GenerateVIsoparametricLines(
 
         for (GLuint v_count = 0; v_count < div_point_count;
              ++v_count, v_iter += v_delta) {
-            PartialDerivatives partial_derivatives(div_point_count);
             if (!CalculatePartialDerivatives(
                     maximum_order_of_derivatives, min(_u_max, u_iter),
                     min(_v_max, v_iter), partial_derivatives)) {
@@ -7,9 +7,12 @@
 #include <GL/glew.h>
 #include <algorithm>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 namespace cagd {
+class LUFactorization;
+
 class TensorProductSurface3
 {
 public:
@@ -33,6 +36,14 @@ protected:
     Matrix<DCoordinate3>
         _data; // the control net (usually stores position vectors)
 
+    // factorized u- and v-collocation matrices of the last interpolation
+    // problem, reused as long as the corresponding knot vector (and the
+    // definition domain) does not change
+    RowMatrix<GLdouble>                    _u_interpolation_knot_vector;
+    std::shared_ptr<const LUFactorization> _u_interpolation_factorization;
+    ColumnMatrix<GLdouble>                 _v_interpolation_knot_vector;
+    std::shared_ptr<const LUFactorization> _v_interpolation_factorization;
+
 public:
     // homework: special constructor
     TensorProductSurface3(GLdouble u_min, GLdouble u_max, GLdouble v_min,
@@ -1,4 +1,5 @@
 #include "TriangulatedMeshes3.h"
+#include "CoordinateArrays3.h"
 #include <algorithm>
 #include <cstring>
 #include <fstream>
@@ -62,6 +63,52 @@ TriangulatedMesh3 &TriangulatedMesh3::operator=(const TriangulatedMesh3 &rhs)
     return *this;
 }
 
+TriangulatedMesh3::TriangulatedMesh3(TriangulatedMesh3 &&mesh) noexcept
+    : _usage_flag(mesh._usage_flag)
+    , _vbo_vertices(mesh._vbo_vertices)
+    , _vbo_normals(mesh._vbo_normals)
+    , _vbo_tex_coordinates(mesh._vbo_tex_coordinates)
+    , _vbo_indices(mesh._vbo_indices)
+    , _leftmost_vertex(mesh._leftmost_vertex)
+    , _rightmost_vertex(mesh._rightmost_vertex)
+    , _vertex(std::move(mesh._vertex))
+    , _normal(std::move(mesh._normal))
+    , _tex(std::move(mesh._tex))
+    , _face(std::move(mesh._face))
+{
+    mesh._vbo_vertices        = 0;
+    mesh._vbo_normals         = 0;
+    mesh._vbo_tex_coordinates = 0;
+    mesh._vbo_indices         = 0;
+}
+
+TriangulatedMesh3 &TriangulatedMesh3::
+                   operator=(TriangulatedMesh3 &&rhs) noexcept
+{
+    if (this != &rhs) {
+        DeleteVertexBufferObjects();
+
+        _usage_flag          = rhs._usage_flag;
+        _vbo_vertices        = rhs._vbo_vertices;
+        _vbo_normals         = rhs._vbo_normals;
+        _vbo_tex_coordinates = rhs._vbo_tex_coordinates;
+        _vbo_indices         = rhs._vbo_indices;
+        _leftmost_vertex     = rhs._leftmost_vertex;
+        _rightmost_vertex    = rhs._rightmost_vertex;
+        _vertex              = std::move(rhs._vertex);
+        _normal              = std::move(rhs._normal);
+        _tex                 = std::move(rhs._tex);
+        _face                = std::move(rhs._face);
+
+        rhs._vbo_vertices        = 0;
+        rhs._vbo_normals         = 0;
+        rhs._vbo_tex_coordinates = 0;
+        rhs._vbo_indices         = 0;
+    }
+
+    return *this;
+}
+
 GLvoid TriangulatedMesh3::DeleteVertexBufferObjects()
 {
     if (_vbo_vertices) {
@@ -193,12 +240,16 @@ GLboolean TriangulatedMesh3::UpdateVertexBufferObjects(GLenum usage_flag)
         return GL_FALSE;
     }
 
-    // For efficiency reasons we convert all GLdouble coordinates
-    // to GLfloat coordinates: we will use auxiliar pointers for
-    // buffer data loading and functions glMapBuffer/glUnmapBuffer.
+    // Vertices and normals are stored as tightly packed GLfloat triplets, so
+    // they are copied into the buffers as they are, just like the texture
+    // coordinates: we will use auxiliar pointers for buffer data loading and
+    // functions glMapBuffer/glUnmapBuffer.
 
     // Notice that multiple buffers can be mapped simultaneously.
 
+    static_assert(sizeof(FCoordinate3) == 3 * sizeof(GLfloat),
+                  "FCoordinate3 has to consist of three GLfloats");
+
     GLuint vertex_byte_size = 3 * (GLuint)_vertex.size() * sizeof(GLfloat);
 
     glBindBuffer(GL_ARRAY_BUFFER, _vbo_vertices);
@@ -207,23 +258,15 @@ GLboolean TriangulatedMesh3::UpdateVertexBufferObjects(GLenum usage_flag)
     GLfloat *vertex_coordinate =
         (GLfloat *)glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
 
+    memcpy(vertex_coordinate, _vertex.data(), vertex_byte_size);
+
     glBindBuffer(GL_ARRAY_BUFFER, _vbo_normals);
     glBufferData(GL_ARRAY_BUFFER, vertex_byte_size, 0, _usage_flag);
 
     GLfloat *normal_coordinate =
         (GLfloat *)glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
 
-    for (vector<DCoordinate3>::const_iterator vit = _vertex.begin(),
-                                              nit = _normal.begin();
-         vit != _vertex.end(); ++vit, ++nit) {
-        for (GLint component = 0; component < 3; ++component) {
-            *vertex_coordinate = (GLfloat)(*vit)[component];
-            ++vertex_coordinate;
-
-            *normal_coordinate = (GLfloat)(*nit)[component];
-            ++normal_coordinate;
-        }
-    }
+    memcpy(normal_coordinate, _normal.data(), vertex_byte_size);
 
     GLuint tex_byte_size = 4 * (GLuint)_tex.size() * sizeof(GLfloat);
 
@@ -309,43 +352,32 @@ TriangulatedMesh3::LoadFromOFF(const string &file_name,
 
     // initializing the leftmost and rightmost corners of the bounding box
     _leftmost_vertex.x() = _leftmost_vertex.y() = _leftmost_vertex.z() =
-        numeric_limits<GLdouble>::max();
+        numeric_limits<GLfloat>::max();
     _rightmost_vertex.x() = _rightmost_vertex.y() = _rightmost_vertex.z() =
-        -numeric_limits<GLdouble>::max();
+        -numeric_limits<GLfloat>::max();
 
-    // loading vertices and correcting the leftmost and rightmost corners of the
-    // bounding box
-    for (vector<DCoordinate3>::iterator vit = _vertex.begin();
-         vit != _vertex.end(); ++vit) {
+    // loading vertices
+    for (vector<FCoordinate3>::iterator vit = _vertex.begin();
+         vit != _vertex.end(); ++vit)
         f >> *vit;
 
-        if (vit->x() < _leftmost_vertex.x())
-            _leftmost_vertex.x() = vit->x();
-        if (vit->y() < _leftmost_vertex.y())
-            _leftmost_vertex.y() = vit->y();
-        if (vit->z() < _leftmost_vertex.z())
-            _leftmost_vertex.z() = vit->z();
-
-        if (vit->x() > _rightmost_vertex.x())
-            _rightmost_vertex.x() = vit->x();
-        if (vit->y() > _rightmost_vertex.y())
-            _rightmost_vertex.y() = vit->y();
-        if (vit->z() > _rightmost_vertex.z())
-            _rightmost_vertex.z() = vit->z();
-    }
+    // correcting the leftmost and rightmost corners of the bounding box
+    if (vertex_count)
+        GetBoundingBox(FCoordinateArray3(&_vertex[0], vertex_count),
+                       _leftmost_vertex, _rightmost_vertex);
 
     // if we do not want to preserve the original positions and coordinates of
     // vertices
     if (translate_and_scale_to_unit_cube) {
-        GLdouble scale =
-            1.0 / max(_rightmost_vertex.x() - _leftmost_vertex.x(),
+        GLfloat scale =
+            1.0f / max(_rightmost_vertex.x() - _leftmost_vertex.x(),
                       max(_rightmost_vertex.y() - _leftmost_vertex.y(),
                           _rightmost_vertex.z() - _leftmost_vertex.z()));
 
-        DCoordinate3 middle(_leftmost_vertex);
+        FCoordinate3 middle(_leftmost_vertex);
         middle += _rightmost_vertex;
-        middle *= 0.5;
-        for (vector<DCoordinate3>::iterator vit = _vertex.begin();
+        middle *= 0.5f;
+        for (vector<FCoordinate3>::iterator vit = _vertex.begin();
              vit != _vertex.end(); ++vit) {
             *vit -= middle;
             *vit *= scale;
@@ -357,24 +389,34 @@ TriangulatedMesh3::LoadFromOFF(const string &file_name,
          fit != _face.end(); ++fit)
         f >> *fit;
 
-    // calculating average unit normal vectors associated with vertices
-    for (vector<TriangularFace>::const_iterator fit = _face.begin();
-         fit != _face.end(); ++fit) {
-        DCoordinate3 n = _vertex[(*fit)[1]];
-        n -= _vertex[(*fit)[0]];
+    // calculating the (non-unit) face normals as cross products of edge vectors
+    FCoordinateArray3 face_normal(face_count), edge(face_count);
 
-        DCoordinate3 p = _vertex[(*fit)[2]];
-        p -= _vertex[(*fit)[0]];
+    for (GLuint i = 0; i < face_count; ++i) {
+        const TriangularFace &face = _face[i];
 
-        n ^= p;
+        face_normal.Set(i, _vertex[face[1]] - _vertex[face[0]]);
+        edge.Set(i, _vertex[face[2]] - _vertex[face[0]]);
+    }
+
+    CrossAll(face_normal, edge, face_normal);
+
+    // calculating average unit normal vectors associated with vertices
+    FCoordinateArray3 vertex_normal(vertex_count);
 
-        for (GLint node = 0; node < 3; ++node)
-            _normal[(*fit)[node]] += n;
+    for (GLuint i = 0; i < face_count; ++i) {
+        const TriangularFace &face = _face[i];
+
+        for (GLint node = 0; node < 3; ++node) {
+            vertex_normal.X()[face[node]] += face_normal.X()[i];
+            vertex_normal.Y()[face[node]] += face_normal.Y()[i];
+            vertex_normal.Z()[face[node]] += face_normal.Z()[i];
+        }
     }
 
-    for (vector<DCoordinate3>::iterator nit = _normal.begin();
-         nit != _normal.end(); ++nit)
-        nit->normalize();
+    NormalizeAll(vertex_normal);
+    if (vertex_count)
+        vertex_normal.Scatter(&_normal[0]);
 
     f.close();
 
@@ -395,7 +437,7 @@ GLboolean TriangulatedMesh3::SaveToOFF(const string &file_name) const
     ofile << _vertex.size() << ' ' << _face.size() << " 0\n";
 
 
-    for (const DCoordinate3 &vertex : _vertex) {
+    for (const FCoordinate3 &vertex : _vertex) {
         ofile << vertex << '\n';
     }
 
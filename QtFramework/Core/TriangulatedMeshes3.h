@@ -35,12 +35,13 @@ protected:
     GLuint _vbo_indices;
 
     // corners of bounding box
-    DCoordinate3 _leftmost_vertex;
-    DCoordinate3 _rightmost_vertex;
+    FCoordinate3 _leftmost_vertex;
+    FCoordinate3 _rightmost_vertex;
 
-    // geometry
-    std::vector<DCoordinate3>   _vertex;
-    std::vector<DCoordinate3>   _normal;
+    // geometry, meshes are meant for display, hence vertices and normals are
+    // stored in single precision, in the format of the vertex buffer objects
+    std::vector<FCoordinate3>   _vertex;
+    std::vector<FCoordinate3>   _normal;
     std::vector<TCoordinate4>   _tex;
     std::vector<TriangularFace> _face;
 
@@ -52,9 +53,15 @@ public:
     // copy constructor
     TriangulatedMesh3(const TriangulatedMesh3 &mesh);
 
+    // move constructor, takes over the vertex buffer objects of mesh
+    TriangulatedMesh3(TriangulatedMesh3 &&mesh) noexcept;
+
     // assignment operator
     TriangulatedMesh3 &operator=(const TriangulatedMesh3 &rhs);
 
+    // move assignment operator, takes over the vertex buffer objects of rhs
+    TriangulatedMesh3 &operator=(TriangulatedMesh3 &&rhs) noexcept;
+
     // deletes all vertex buffer objects
     GLvoid DeleteVertexBufferObjects();
 
@@ -1,51 +1,142 @@
 #include "CyclicCurves3.h"
 
+#include "../Core/BandedSquareMatrices.h"
 #include "../Core/Constants.h"
+#include "../Core/FastFourierTransforms.h"
+#include "../Core/RealSquareMatrices.h"
 
+#include <algorithm>
+#include <cfloat>
 #include <cmath>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <vector>
 
 using namespace std;
 
 namespace cagd {
-GLdouble CyclicCurve3::_CalculateNormalizingCoefficient(GLuint n)
+CyclicCurve3::Tables::Tables(GLuint n)
+    : n(n)
+    , c_n(1.0)
+    , lambda_n(TWO_PI / (2 * n + 1))
+    , binomial(2 * n + 1)
+    , fourier_weight(n + 1)
+    , phase(2 * n + 1)
+    , cosine(2 * n + 1)
+    , sine(2 * n + 1)
 {
-    if (!n) {
-        return 1.0;
+    GLuint m = 2 * n + 1;
+
+    // normalizing constant
+    if (n) {
+        c_n = 1.0 / 3.0;
+
+        for (GLuint i = 2; i <= n; ++i) {
+            c_n *= (GLdouble)i / (GLdouble)(2 * i + 1);
+        }
     }
 
-    GLdouble c = 1.0 / 3.0;
+    // the row 2n of Pascal's triangle
+    binomial[0] = 1.0;
+    for (GLuint r = 1; r < m; ++r) {
+        binomial[r] = 1.0;
+        for (GLuint i = r - 1; i >= 1; --i) {
+            binomial[i] += binomial[i - 1];
+        }
+    }
 
-    for (GLuint i = 2; i <= n; ++i) {
-        c *= (GLdouble)i / (GLdouble)(2 * i + 1);
+    fourier_weight[0] = 1.0 / m;
+    for (GLuint j = 1; j <= n; ++j) {
+        fourier_weight[j] = 2.0 * binomial[n - j] / (m * binomial[n]);
     }
 
-    return c;
+    for (GLuint i = 0; i < m; ++i) {
+        phase[i]  = i * lambda_n;
+        cosine[i] = cos(phase[i]);
+        sine[i]   = sin(phase[i]);
+    }
 }
 
-GLvoid
-CyclicCurve3::_CalculateBinomialCoefficients(GLuint                      m,
-                                             TriangularMatrix<GLdouble> &bc)
+shared_ptr<const CyclicCurve3::Tables> CyclicCurve3::GetTables(GLuint n)
 {
-    bc.ResizeRows(m + 1);
-    bc(0, 0) = 1.0;
-    for (GLuint r = 1; r <= m; ++r) {
-        bc(r, 0) = 1.0;
-        bc(r, r) = 1.0;
-        for (GLuint i = 1; i <= r / 2; ++i) {
-            bc(r, i)     = bc(r - 1, i - 1) + bc(r - 1, i);
-            bc(r, r - i) = bc(r, i);
-        }
+    // the cache refers to the tables weakly, expired entries are refilled
+    static mutex                               cache_mutex;
+    static map<GLuint, weak_ptr<const Tables>> cache;
+
+    lock_guard<mutex> lock(cache_mutex);
+
+    shared_ptr<const Tables> tables = cache[n].lock();
+
+    if (!tables) {
+        tables   = make_shared<const Tables>(n);
+        cache[n] = tables;
     }
+
+    return tables;
 }
 
 CyclicCurve3::CyclicCurve3(GLuint n, GLenum data_usage_flag)
-    : LinearCombination3(0.0, TWO_PI, 2 * n + 1, data_usage_flag)
+    : LinearCombinationEngine3<CyclicCurve3>(0.0, TWO_PI, 2 * n + 1,
+                                             data_usage_flag)
     , _n(n)
-    , _c_n(_CalculateNormalizingCoefficient(n))
-    , _lambda_n(TWO_PI / (2 * n + 1))
+    , _tables(GetTables(n))
+    , _fourier_coefficients_are_up_to_date(GL_FALSE)
+    , _fourier_data_revision(0)
 {
-    _CalculateBinomialCoefficients(2 * _n, _bc);
+    _c_n      = _tables->c_n;
+    _lambda_n = _tables->lambda_n;
+}
+
+// Expanding the blending functions, the derivative of order r of the curve is
+//   2 / ((2n+1) binom(2n,n)) sum_{j=1}^{n} j^r binom(2n,n-j)
+//     sum_{i=0}^{2n} cos(j(u - i lambda_n) + r pi / 2) d_i
+// (plus the centroid of the control points if r = 0), therefore
+//   a_j = s_j sum_{i=0}^{2n} cos(j i lambda_n) d_i and
+//   b_j = s_j sum_{i=0}^{2n} sin(j i lambda_n) d_i,
+// where s_j = 2 binom(2n,n-j) / ((2n+1) binom(2n,n)).
+GLvoid CyclicCurve3::_UpdateFourierCoefficients() const
+{
+    if (_fourier_coefficients_are_up_to_date &&
+        _fourier_data_revision == _data_revision)
+        return;
+
+    GLuint m = 2 * _n + 1;
+
+    _fourier_a.ResizeColumns(_n + 1);
+    _fourier_b.ResizeColumns(_n + 1);
+
+    // cos(j i lambda_n) = cos(((j i) mod (2n+1)) lambda_n), thus the needed
+    // trigonometric values are taken from the tables of the order
+    const RowMatrix<GLdouble> &cosine = _tables->cosine;
+    const RowMatrix<GLdouble> &sine   = _tables->sine;
+
+    DCoordinate3 centroid;
+    for (GLuint i = 0; i < m; ++i) {
+        centroid += _data[i];
+    }
+    centroid /= (GLdouble)m;
+
+    _fourier_a[0] = centroid;
+    _fourier_b[0] = DCoordinate3();
+
+    for (GLuint j = 1; j <= _n; ++j) {
+        DCoordinate3 a, b;
+
+        for (GLuint i = 0; i < m; ++i) {
+            GLuint k = (j * i) % m;
+            a += cosine[k] * _data[i];
+            b += sine[k] * _data[i];
+        }
+
+        GLdouble s = _tables->fourier_weight[j];
+
+        _fourier_a[j] = s * a;
+        _fourier_b[j] = s * b;
+    }
+
+    _fourier_data_revision               = _data_revision;
+    _fourier_coefficients_are_up_to_date = GL_TRUE;
 }
 
 GLboolean
@@ -54,44 +145,441 @@ CyclicCurve3::BlendingFunctionValues(GLdouble             u,
 {
     values.ResizeColumns(2 * _n + 1);
 
+    // cos(u - i lambda_n) = cos(u) cos(i lambda_n) + sin(u) sin(i lambda_n)
+    GLdouble cos_u = cos(u), sin_u = sin(u);
+
     for (GLuint i = 0; i < 2 * _n + 1; ++i) {
-        values[i] = _c_n * pow(1.0 + cos(u - i * _lambda_n), (GLint)_n);
+        values[i] = _c_n * pow(1.0 + cos_u * _tables->cosine[i] +
+                                   sin_u * _tables->sine[i],
+                               (GLint)_n);
     }
 
     return GL_TRUE;
 }
 
-GLboolean CyclicCurve3::CalculateDerivatives(GLuint   max_order_of_derivatives,
-                                             GLdouble u, Derivatives &d) const
+// F_i^{(r)}(u) = s sum_{j=1}^{n} j^r binom(2n,n-j) cos(j(u - i lambda_n) + r pi/2)
+// (plus 1 / (2n+1) if r = 0), where s = 2 / ((2n+1) binom(2n,n)); the values
+// cos(j theta) and sin(j theta) are obtained by successive rotations
+GLboolean CyclicCurve3::BlendingFunctionDerivatives(
+    GLuint max_order_of_derivatives, GLdouble u, Matrix<GLdouble> &values) const
 {
-    d.ResizeRows(max_order_of_derivatives + 1);
-    d.LoadNullVectors();
+    GLuint m = 2 * _n + 1;
 
-    DCoordinate3 centroid;
+    if (!values.ResizeRows(max_order_of_derivatives + 1) ||
+        !values.ResizeColumns(m)) {
+        return GL_FALSE;
+    }
 
-    for (GLuint i = 0; i <= 2 * _n; ++i) {
-        centroid += _data[i];
+    GLdouble cos_u = cos(u), sin_u = sin(u);
+
+    for (GLuint i = 0; i < m; ++i) {
+        // theta = u - i lambda_n
+        GLdouble cos_theta =
+            cos_u * _tables->cosine[i] + sin_u * _tables->sine[i];
+        GLdouble sin_theta =
+            sin_u * _tables->cosine[i] - cos_u * _tables->sine[i];
+
+        for (GLuint r = 0; r <= max_order_of_derivatives; ++r) {
+            values(r, i) = r ? 0.0 : 1.0 / m;
+        }
+
+        GLdouble cos_j = 1.0, sin_j = 0.0;
+
+        for (GLuint j = 1; j <= _n; ++j) {
+            GLdouble next_cos = cos_j * cos_theta - sin_j * sin_theta;
+            sin_j             = sin_j * cos_theta + cos_j * sin_theta;
+            cos_j             = next_cos;
+
+            GLdouble weight = _tables->fourier_weight[j];
+
+            for (GLuint r = 0; r <= max_order_of_derivatives; ++r) {
+                // cos(x + r pi / 2) = cos x, -sin x, -cos x, sin x
+                switch (r % 4) {
+                case 0:
+                    values(r, i) += weight * cos_j;
+                    break;
+                case 1:
+                    values(r, i) -= weight * sin_j;
+                    break;
+                case 2:
+                    values(r, i) -= weight * cos_j;
+                    break;
+                default:
+                    values(r, i) += weight * sin_j;
+                    break;
+                }
+
+                weight *= j;
+            }
+        }
     }
 
-    centroid /= (GLdouble)(2 * _n + 1);
+    return GL_TRUE;
+}
+
+GLvoid CyclicCurve3::_PrepareEvaluation() const
+{
+    _UpdateFourierCoefficients();
+}
+
+GLvoid CyclicCurve3::_EvaluateDerivatives(GLuint max_order_of_derivatives,
+                                          GLdouble u, DCoordinate3 *d,
+                                          GLuint stride) const
+{
+    GLdouble cos_u = cos(u), sin_u = sin(u), two_cos_u = 2.0 * cos_u;
 
     for (GLuint r = 0; r <= max_order_of_derivatives; ++r) {
-        for (GLuint i = 0; i <= 2 * _n; ++i) {
-            GLdouble sum_k = 0.0;
+        // Clenshaw's recurrence
+        //   beta_j = j^r c_j + 2 cos(u) beta_{j+1} - beta_{j+2},
+        // after which sum_{j=1}^{n} j^r c_j cos(ju) = beta_1 cos(u) - beta_2
+        // and sum_{j=1}^{n} j^r c_j sin(ju) = beta_1 sin(u), for both the
+        // cosine (c = a) and the sine (c = b) coefficients
+        DCoordinate3 alpha_1, alpha_2, beta_1, beta_2;
 
-            for (GLuint k = 0; k <= _n - 1; ++k) {
-                sum_k += pow(_n - k, (GLint)r) * _bc(2 * _n, k) *
-                         cos((_n - k) * (u - i * _lambda_n) + r * PI / 2.0);
+        for (GLuint j = _n; j >= 1; --j) {
+            GLdouble j_to_r = 1.0;
+            for (GLuint q = 0; q < r; ++q) {
+                j_to_r *= j;
             }
 
-            d[r] += sum_k * _data[i];
+            DCoordinate3 alpha = j_to_r * _fourier_a[j];
+            alpha += two_cos_u * alpha_1;
+            alpha -= alpha_2;
+            alpha_2 = alpha_1;
+            alpha_1 = alpha;
+
+            DCoordinate3 beta = j_to_r * _fourier_b[j];
+            beta += two_cos_u * beta_1;
+            beta -= beta_2;
+            beta_2 = beta_1;
+            beta_1 = beta;
+        }
+
+        DCoordinate3 a_cos = cos_u * alpha_1 - alpha_2, a_sin = sin_u * alpha_1;
+        DCoordinate3 b_cos = cos_u * beta_1 - beta_2, b_sin = sin_u * beta_1;
+
+        // the derivative of order r shifts the phase by r pi / 2
+        switch (r % 4) {
+        case 0:
+            d[r * stride] = a_cos + b_sin;
+            break;
+        case 1:
+            d[r * stride] = b_cos - a_sin;
+            break;
+        case 2:
+            d[r * stride] = -(a_cos + b_sin);
+            break;
+        default:
+            d[r * stride] = a_sin - b_cos;
+            break;
+        }
+    }
+
+    d[0] += _fourier_a[0];
+}
+
+GenericCurve3 *CyclicCurve3::GenerateImage(GLuint max_order_of_derivatives,
+                                           GLuint div_point_count,
+                                           GLenum usage_flag) const
+{
+    // Clenshaw's recurrence needs n steps per point and derivative order,
+    // while the three coordinate functions of a derivative order need one and a
+    // half transforms; the FFT is used if the definition domain is a full
+    // period and it is cheaper
+    if (div_point_count >= 2 &&
+        fabs(_u_max - _u_min - TWO_PI) <= 1.0e-12 * TWO_PI &&
+        (GLdouble)div_point_count * _n >=
+            1.5 * FastFourierTransform::GetButterflyCount(div_point_count)) {
+        return _GenerateImageByFFT(max_order_of_derivatives, div_point_count,
+                                   usage_flag);
+    }
+
+    return LinearCombinationEngine3<CyclicCurve3>::GenerateImage(
+        max_order_of_derivatives, div_point_count, usage_flag);
+}
+
+// The points u_k = u_min + 2 k pi / N, k = 0, 1, ..., N - 1, are sampled,
+// where N = div_point_count, and the last point of the image is the image of
+// u_max = u_min + 2 pi, i.e., it coincides with the first one. The r-th
+// derivative of a coordinate function is
+//   sum_{j=0}^{n} Re(z_j exp(2 pi i j k / N)),
+//   z_j = (a_j - i b_j) (i j)^r exp(i j u_min),
+// i.e., the inverse DFT of a Hermitian spectrum, which has a real result.
+// Therefore, two coordinate functions are transformed at once as the real and
+// imaginary parts of a single complex signal.
+GenericCurve3 *
+CyclicCurve3::_GenerateImageByFFT(GLuint max_order_of_derivatives,
+                                  GLuint div_point_count,
+                                  GLenum usage_flag) const
+{
+    typedef FastFourierTransform::Complex Complex;
+
+    _UpdateFourierCoefficients();
+
+    GLuint N = div_point_count;
+
+    if (!_image_fft || _image_fft->GetSize() != N) {
+        _image_fft = make_shared<const FastFourierTransform>(N);
+    }
+
+    const FastFourierTransform &ifft = *_image_fft;
+
+    vector<Complex> phase(_n + 1);
+    for (GLuint j = 0; j <= _n; ++j) {
+        phase[j] = Complex(cos(j * _u_min), sin(j * _u_min));
+    }
+
+    Matrix<DCoordinate3> derivative(max_order_of_derivatives + 1, N);
+
+    GLuint          signal_count = 3 * (max_order_of_derivatives + 1);
+    vector<Complex> spectrum(N);
+
+    for (GLuint s = 0; s < signal_count; s += 2) {
+        fill(spectrum.begin(), spectrum.end(), Complex(0.0, 0.0));
+
+        // the signal s is the real, while the signal s + 1 is the imaginary
+        // part of the transformed data
+        for (GLuint q = 0; q < 2 && s + q < signal_count; ++q) {
+            GLuint r         = (s + q) / 3;
+            GLuint component = (s + q) % 3;
+
+            for (GLuint j = 0; j <= _n; ++j) {
+                GLdouble j_to_r = 1.0;
+                for (GLuint p = 0; p < r; ++p) {
+                    j_to_r *= j;
+                }
+
+                // the rotations by exp(i j u_min), i^r and i are applied
+                // componentwise, to avoid the slow operator * of std::complex
+                Complex z = Complex(_fourier_a[j][component],
+                                    -_fourier_b[j][component]) *
+                            j_to_r;
+                z = Complex(z.real() * phase[j].real() - z.imag() * phase[j].imag(),
+                            z.real() * phase[j].imag() + z.imag() * phase[j].real());
+                for (GLuint p = 0; p < r % 4; ++p) {
+                    z = Complex(-z.imag(), z.real());
+                }
+
+                GLuint m = j % N;
+                if (q) {
+                    spectrum[m] += 0.5 * Complex(-z.imag(), z.real());
+                    spectrum[(N - m) % N] += 0.5 * Complex(z.imag(), z.real());
+                } else {
+                    spectrum[m] += 0.5 * z;
+                    spectrum[(N - m) % N] += 0.5 * conj(z);
+                }
+            }
+        }
+
+        ifft.Transform(spectrum, GL_TRUE);
+
+        for (GLuint q = 0; q < 2 && s + q < signal_count; ++q) {
+            GLuint r         = (s + q) / 3;
+            GLuint component = (s + q) % 3;
+
+            for (GLuint k = 0; k < N - 1; ++k) {
+                derivative(r, k)[component] =
+                    q ? spectrum[k].imag() : spectrum[k].real();
+            }
+
+            derivative(r, N - 1)[component] = derivative(r, 0)[component];
+        }
+    }
+
+    return new GenericCurve3(std::move(derivative), usage_flag);
+}
+
+GLboolean CyclicCurve3::_KnotsAreUniform(
+    const ColumnMatrix<GLdouble> &knot_vector) const
+{
+    for (GLuint k = 1; k < knot_vector.GetRowCount(); ++k) {
+        if (fabs(knot_vector[k] - knot_vector[0] - _tables->phase[k]) >
+            1.0e-12 * TWO_PI) {
+            return GL_FALSE;
+        }
+    }
+
+    return GL_TRUE;
+}
+
+GLboolean CyclicCurve3::_SolveCirculantCollocationSystems(
+    GLdouble u_0, const Matrix<DCoordinate3> &b, Matrix<DCoordinate3> &x) const
+{
+    typedef FastFourierTransform::Complex Complex;
+
+    GLuint m = 2 * _n + 1;
+
+    if (b.GetRowCount() != m || x.GetRowCount() != m ||
+        b.GetColumnCount() != x.GetColumnCount()) {
+        return GL_FALSE;
+    }
+
+    FastFourierTransform fft(m);
+
+    // the first column of the collocation matrix is
+    // g_d = F_0(u_0 + d lambda_n) = F_{(m-d) mod m}(u_0), and its DFT
+    // consists of the eigenvalues of the matrix
+    RowMatrix<GLdouble> values;
+    BlendingFunctionValues(u_0, values);
+
+    vector<Complex> eigenvalue(m);
+    for (GLuint d = 0; d < m; ++d) {
+        eigenvalue[d] = values[(m - d) % m];
+    }
+
+    fft.Transform(eigenvalue);
+
+    GLdouble largest_modulus = 0.0;
+    for (GLuint j = 0; j < m; ++j) {
+        largest_modulus = max(largest_modulus, abs(eigenvalue[j]));
+    }
+
+    // the reciprocals of the eigenvalues also include the normalization of
+    // the inverse transform
+    vector<Complex> factor(m);
+    for (GLuint j = 0; j < m; ++j) {
+        if (abs(eigenvalue[j]) <= m * DBL_EPSILON * largest_modulus) {
+            return GL_FALSE;
+        }
+
+        factor[j] = 1.0 / ((GLdouble)m * eigenvalue[j]);
+    }
+
+    // The inverse of a circulant matrix is circulant, its first column h is
+    // the inverse DFT of the reciprocal eigenvalues. Applying it costs m^2
+    // multiply-adds per right-hand side, which is cheaper than two transforms
+    // unless the order is high.
+    if ((GLdouble)m * m <=
+        _circulant_product_ratio * FastFourierTransform::GetButterflyCount(m)) {
+        vector<Complex> h(factor);
+        fft.Transform(h, GL_TRUE);
+
+        // x_k = sum_i h_{(k-i) mod m} b_i, thus h is stored twice, in reversed
+        // order
+        vector<GLdouble> reversed_h(2 * m);
+        for (GLuint t = 0; t < 2 * m; ++t) {
+            reversed_h[t] = h[(2 * m - t) % m].real();
+        }
+
+        GLint column_count = (GLint)b.GetColumnCount();
+
+#pragma omp parallel for schedule(static) if (column_count >= 8)
+        for (GLint c = 0; c < column_count; ++c) {
+            for (GLuint k = 0; k < m; ++k) {
+                const GLdouble *row = &reversed_h[m - k];
+
+                DCoordinate3 sum;
+                for (GLuint i = 0; i < m; ++i) {
+                    sum += row[i] * b(i, c);
+                }
+
+                x(k, c) = sum;
+            }
+        }
+
+        return GL_TRUE;
+    }
+
+    // two real right-hand sides are solved at once as the real and imaginary
+    // parts of a complex one, since the collocation matrix is real
+    GLint signal_count = 3 * (GLint)b.GetColumnCount();
+    GLint pair_count   = (signal_count + 1) / 2;
+
+#pragma omp parallel for schedule(dynamic) if (pair_count >= 8)
+    for (GLint p = 0; p < pair_count; ++p) {
+        vector<Complex> signal(m);
+
+        GLint  s[2]         = {2 * p, min(2 * p + 1, signal_count - 1)};
+        GLuint column[2]    = {(GLuint)s[0] / 3, (GLuint)s[1] / 3};
+        GLuint component[2] = {(GLuint)s[0] % 3, (GLuint)s[1] % 3};
+
+        GLboolean has_pair = (s[1] != s[0]);
+
+        for (GLuint k = 0; k < m; ++k) {
+            signal[k] = Complex(b(k, column[0])[component[0]],
+                                has_pair ? b(k, column[1])[component[1]] : 0.0);
+        }
+
+        fft.Transform(signal);
+
+        for (GLuint j = 0; j < m; ++j) {
+            signal[j] *= factor[j];
+        }
+
+        fft.Transform(signal, GL_TRUE);
+
+        for (GLuint k = 0; k < m; ++k) {
+            x(k, column[0])[component[0]] = signal[k].real();
+
+            if (has_pair) {
+                x(k, column[1])[component[1]] = signal[k].imag();
+            }
         }
-        d[r] *= 2.0;
-        d[r] /= (GLdouble)(2 * _n + 1);
-        d[r] /= _bc(2 * _n, _n);
     }
-    d[0] += centroid;
 
     return GL_TRUE;
 }
+
+GLboolean CyclicCurve3::UpdateDataForInterpolation(
+    const ColumnMatrix<GLdouble> &    knot_vector,
+    const ColumnMatrix<DCoordinate3> &data_points_to_interpolate)
+{
+    GLuint m = 2 * _n + 1;
+
+    if (knot_vector.GetRowCount() != m ||
+        data_points_to_interpolate.GetRowCount() != m ||
+        !_KnotsAreUniform(knot_vector)) {
+        return LinearCombination3::UpdateDataForInterpolation(
+            knot_vector, data_points_to_interpolate);
+    }
+
+    ++_data_revision;
+
+    return _SolveCirculantCollocationSystems(
+        knot_vector[0], data_points_to_interpolate, _data);
+}
+
+GLboolean CyclicCurve3::SolveInterpolationProblems(
+    const ColumnMatrix<GLdouble> &knot_vector,
+    const Matrix<DCoordinate3> &  data_points_to_interpolate,
+    Matrix<DCoordinate3> &        control_points) const
+{
+    GLuint m = 2 * _n + 1;
+
+    if (knot_vector.GetRowCount() != m ||
+        data_points_to_interpolate.GetRowCount() != m) {
+        return GL_FALSE;
+    }
+
+    if (!control_points.ResizeRows(m) ||
+        !control_points.ResizeColumns(
+            data_points_to_interpolate.GetColumnCount())) {
+        return GL_FALSE;
+    }
+
+    if (_KnotsAreUniform(knot_vector)) {
+        return _SolveCirculantCollocationSystems(
+            knot_vector[0], data_points_to_interpolate, control_points);
+    }
+
+    // general knots: a single dense factorization for all curves
+    RealSquareMatrix    collocation_matrix(m);
+    RowMatrix<GLdouble> values;
+
+    for (GLuint k = 0; k < m; ++k) {
+        if (!BlendingFunctionValues(knot_vector[k], values) ||
+            !collocation_matrix.SetRow(k, values)) {
+            return GL_FALSE;
+        }
+    }
+
+    shared_ptr<const LUFactorization> factorization =
+        BandedSquareMatrix::FactorizeAutomatically(collocation_matrix);
+
+    if (!factorization) {
+        return GL_FALSE;
+    }
+
+    return factorization->Solve(data_points_to_interpolate, control_points);
+}
 }; // namespace cagd
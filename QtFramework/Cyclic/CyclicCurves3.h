@@ -1,28 +1,122 @@
 #pragma once
 
-#include "../Core/LinearCombination3.h"
+#include "../Core/LinearCombinationEngine3.h"
 #include "../Core/Matrices.h"
+#include <memory>
 
 namespace cagd {
-class CyclicCurve3 : public LinearCombination3
+class FastFourierTransform;
+
+class CyclicCurve3 : public LinearCombinationEngine3<CyclicCurve3>
 {
+    friend class LinearCombinationEngine3<CyclicCurve3>;
+
+public:
+    // Quantities that depend only on the order. They are calculated once per
+    // order and shared by every cyclic curve of that order, thus constructing
+    // a curve does not cost more than allocating its control points.
+    class Tables
+    {
+    public:
+        GLuint   n;        // order
+        GLdouble c_n;      // normalizing constant
+        GLdouble lambda_n; // phase change
+
+        // binomial coefficients binom(2n, k), k = 0, 1, ..., 2n
+        RowMatrix<GLdouble> binomial;
+
+        // weights of the Fourier coefficients, s_0 = 1 / (2n+1) and
+        // s_j = 2 binom(2n,n-j) / ((2n+1) binom(2n,n)), j = 1, 2, ..., n
+        RowMatrix<GLdouble> fourier_weight;
+
+        // phases i lambda_n and their cosines and sines, i = 0, 1, ..., 2n
+        RowMatrix<GLdouble> phase, cosine, sine;
+
+        // special constructor
+        Tables(GLuint n);
+    };
+
+    // returns the tables of the given order from a process-wide cache, it
+    // can be called by several threads at the same time; the tables of an
+    // order are released together with the last curve that uses them
+    static std::shared_ptr<const Tables> GetTables(GLuint n);
+
 protected:
     GLuint   _n;        // order
     GLdouble _c_n;      // normalizing constant
     GLdouble _lambda_n; // phase change
 
-    TriangularMatrix<GLdouble> _bc; // binomial coefficients
+    std::shared_ptr<const Tables> _tables;
 
-    GLdouble _CalculateNormalizingCoefficient(GLuint n);
+    // The curve is a trigonometric polynomial of order n, i.e.,
+    //   c(u) = a_0 + sum_{j=1}^{n} (a_j cos(ju) + b_j sin(ju)),
+    // its Fourier coefficients are calculated from the control points on
+    // demand, and they are recalculated only if the data revision changes.
+    mutable GLboolean               _fourier_coefficients_are_up_to_date;
+    mutable GLuint                  _fourier_data_revision;
+    mutable RowMatrix<DCoordinate3> _fourier_a, _fourier_b;
 
-    GLvoid _CalculateBinomialCoefficients(GLuint                      m,
-                                          TriangularMatrix<GLdouble> &bc);
+    GLvoid _UpdateFourierCoefficients() const;
+
+    // evaluation interface of LinearCombinationEngine3, the derivatives are
+    // evaluated from the Fourier coefficients by Clenshaw's recurrence
+    GLvoid _PrepareEvaluation() const;
+    GLvoid _EvaluateDerivatives(GLuint max_order_of_derivatives, GLdouble u,
+                                DCoordinate3 *d, GLuint stride) const;
+
+    // transform of the last image generated by inverse FFTs, reused as long as
+    // the number of subdivision points does not change
+    mutable std::shared_ptr<const FastFourierTransform> _image_fft;
+
+    GenericCurve3 *_GenerateImageByFFT(GLuint max_order_of_derivatives,
+                                       GLuint div_point_count,
+                                       GLenum usage_flag) const;
+
+    // checks whether the knots are u_k = u_0 + k lambda_n, k = 0, 1, ..., 2n
+    GLboolean _KnotsAreUniform(const ColumnMatrix<GLdouble> &knot_vector) const;
+
+    // the circulant collocation systems are solved by a product with the
+    // inverse matrix if m^2 <= ratio * (butterflies of a transform of length m),
+    // and by transforms of the right-hand sides otherwise
+    static const GLuint _circulant_product_ratio = 16;
+
+    // Solves the collocation systems of the uniform knots u_k = u_0 + k lambda_n
+    // by FFTs. The collocation matrix (F_i(u_k)) = (F_0(u_0 + (k-i) lambda_n))
+    // is circulant, thus it is diagonalized by the discrete Fourier transform.
+    // The columns of b are the right-hand sides, x has to be of the same size.
+    GLboolean _SolveCirculantCollocationSystems(GLdouble                    u_0,
+                                                const Matrix<DCoordinate3> &b,
+                                                Matrix<DCoordinate3> &x) const;
 
 public:
     CyclicCurve3(GLuint n, GLenum data_usage_flag = GL_STATIC_DRAW);
     GLboolean BlendingFunctionValues(GLdouble             u,
                                      RowMatrix<GLdouble> &values) const;
-    GLboolean CalculateDerivatives(GLuint max_order_of_derivatives, GLdouble u,
-                                   Derivatives &d) const;
+    GLboolean BlendingFunctionDerivatives(GLuint   max_order_of_derivatives,
+                                          GLdouble u,
+                                          Matrix<GLdouble> &values) const;
+
+    // ensures interpolation; uniform knots lead to circulant collocation
+    // systems that are solved in O(n log n) operations, for general knots the
+    // dense solver of LinearCombination3 is used
+    GLboolean UpdateDataForInterpolation(
+        const ColumnMatrix<GLdouble> &    knot_vector,
+        const ColumnMatrix<DCoordinate3> &data_points_to_interpolate);
+
+    // Batch interpolation: determines the control points of several cyclic
+    // curves of the same order that interpolate at the same knots. Column c of
+    // data_points_to_interpolate stores the data points of the c-th curve,
+    // while column c of control_points receives its control points. The
+    // control points of this curve remain unchanged.
+    GLboolean SolveInterpolationProblems(
+        const ColumnMatrix<GLdouble> &knot_vector,
+        const Matrix<DCoordinate3> &  data_points_to_interpolate,
+        Matrix<DCoordinate3> &        control_points) const;
+
+    // samples the same uniform grid as LinearCombination3::GenerateImage, but
+    // evaluates all points at once by inverse FFTs, if it pays off
+    GenericCurve3 *GenerateImage(GLuint max_order_of_derivatives,
+                                 GLuint div_point_count,
+                                 GLenum usage_flag = GL_STATIC_DRAW) const;
 };
 } // namespace cagd
@@ -1,5 +1,6 @@
 #include "GLWidget.h"
 #include "../Core/Constants.h"
+#include "../Core/CoordinateArrays3.h"
 #include <GL/glu.h>
 #include "QFileDialog"
 #include "QColorDialog"
@@ -295,15 +296,11 @@ namespace cagd{
         GLfloat* vertex = _model->MapVertexBuffer(GL_READ_WRITE);
         GLfloat* normal = _model->MapNormalBuffer(GL_READ_ONLY);
 
+        // the buffers store interleaved coordinates, thus every component
+        // can be displaced by a single flat axpy
         if (vertex && normal)
         {
-            for (GLuint i = 0; i < _model->VertexCount(); ++i)
-            {
-                for (GLuint j = 0; j < 3; ++j, vertex++, normal++)
-                {
-                    *vertex += t * (*normal);
-                }
-            }
+            AxpyAll(3 * _model->VertexCount(), (GLfloat) t, normal, vertex);
         }
 
         _model->UnmapVertexBuffer();
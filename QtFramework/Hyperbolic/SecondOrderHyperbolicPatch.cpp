@@ -5,7 +5,18 @@ namespace cagd {
 SecondOrderHyperbolicPatch::SecondOrderHyperbolicPatch(GLdouble alpha_tension)
     : TensorProductSurface3(0, alpha_tension, 0, alpha_tension, 4, 4)
     , _alpha(alpha_tension)
-{}
+{
+    GLdouble sinha2  = sinh(_alpha / 2);
+    GLdouble cosha2  = cosh(_alpha / 2);
+    GLdouble csch3a2 = 1 / (sinha2 * sinha2 * sinha2);
+
+    _f3_c = csch3a2 / sinha2;
+
+    _f2_c1 = 4 * cosha2 * _f3_c;
+    _f2_c2 = (1 + 2 * cosha2 * cosha2) * _f3_c;
+
+    _d1_f2_c = cosha2 / sinha2 * csch3a2;
+}
 
 
 GLdouble SecondOrderHyperbolicPatch::zerothOrderF2(GLdouble t) const
@@ -17,15 +28,7 @@ GLdouble SecondOrderHyperbolicPatch::zerothOrderF2(GLdouble t) const
     GLdouble shhalfw2 = shhalfw * shhalfw;
     GLdouble shhalft3 = shhalft2 * shhalft;
 
-    GLdouble halfal    = _alpha / 2;
-    GLdouble shhalfal4 = sinh(halfal);
-    shhalfal4 *= shhalfal4;
-    shhalfal4 *= shhalfal4;
-    GLdouble chhalfal = cosh(halfal);
-    GLdouble c1       = 4 * chhalfal / shhalfal4;
-    GLdouble c2       = (1 + 2 * chhalfal * chhalfal) / shhalfal4;
-
-    return c1 * shhalfw * shhalft3 + c2 * shhalfw2 * shhalft2;
+    return _f2_c1 * shhalfw * shhalft3 + _f2_c2 * shhalfw2 * shhalft2;
 }
 
 GLdouble SecondOrderHyperbolicPatch::zerothOrderF3(GLdouble t) const
@@ -33,26 +36,13 @@ GLdouble SecondOrderHyperbolicPatch::zerothOrderF3(GLdouble t) const
     GLdouble shhalft4 = sinh(t / 2);
     shhalft4 *= shhalft4;
     shhalft4 *= shhalft4;
-    GLdouble c = sinh(_alpha / 2);
-    c *= c;
-    c *= c;
-    return shhalft4 / c;
+    return shhalft4 * _f3_c;
 }
 
 GLdouble SecondOrderHyperbolicPatch::firstOrderF2(GLdouble t) const
 {
-    GLdouble a2  = _alpha / 2.0;
     GLdouble t2  = t / 2.0;
-    GLdouble at2 = a2 - t2;
-
-    GLdouble cosha2 = cosh(a2);
-    GLdouble sinha2 = sinh(a2);
-
-    GLdouble cosha22 = 2 * pow(cosha2, 2) + 1;
-    GLdouble csch3a2 = 1 / sinha2;
-    GLdouble csch4a2 = csch3a2 * csch3a2;
-    csch4a2 *= csch4a2;
-    csch3a2 *= csch3a2 * csch3a2;
+    GLdouble at2 = (_alpha - t) / 2.0;
 
     GLdouble sinht2  = sinh(t2);
     GLdouble sinht22 = sinht2 * sinht2;
@@ -61,23 +51,36 @@ GLdouble SecondOrderHyperbolicPatch::firstOrderF2(GLdouble t) const
     GLdouble cosht2  = cosh(t2);
     GLdouble coshat2 = cosh(at2);
 
-    GLdouble cotha2 = cosha2 / sinha2;
-
-    return -cosha22 * csch4a2 * sinht22 * sinhat2 * coshat2 +
-           cosha22 * csch4a2 * sinht2 * cosht2 * pow(sinhat2, 2) -
-           2 * cotha2 * csch3a2 * sinht23 * coshat2 +
-           6 * cotha2 * csch3a2 * sinht22 * cosht2 * sinhat2;
+    return -_f2_c2 * sinht22 * sinhat2 * coshat2 +
+           _f2_c2 * sinht2 * cosht2 * sinhat2 * sinhat2 -
+           2 * _d1_f2_c * sinht23 * coshat2 +
+           6 * _d1_f2_c * sinht22 * cosht2 * sinhat2;
 }
 
 GLdouble SecondOrderHyperbolicPatch::firstOrderF3(GLdouble t) const
 {
-    GLdouble c = 1 / sinh(_alpha / 2);
-    c *= c;
-    c *= c;
-
     GLdouble halft   = t / 2;
     GLdouble shhalft = sinh(halft);
-    return 2 * cosh(halft) * c * shhalft * shhalft * shhalft;
+    return 2 * cosh(halft) * _f3_c * shhalft * shhalft * shhalft;
+}
+
+
+GLvoid SecondOrderHyperbolicPatch::zerothOrderBlendingValues(
+    GLdouble t, BlendingValues &values) const
+{
+    values[0] = zerothOrderF3(_alpha - t);
+    values[1] = zerothOrderF2(_alpha - t);
+    values[2] = zerothOrderF2(t);
+    values[3] = zerothOrderF3(t);
+}
+
+GLvoid SecondOrderHyperbolicPatch::firstOrderBlendingValues(
+    GLdouble t, BlendingValues &values) const
+{
+    values[0] = -firstOrderF3(_alpha - t);
+    values[1] = -firstOrderF2(_alpha - t);
+    values[2] = firstOrderF2(t);
+    values[3] = firstOrderF3(t);
 }
 
 
@@ -88,12 +91,14 @@ GLboolean SecondOrderHyperbolicPatch::UBlendingFunctionValues(
         return GL_FALSE;
     }
 
+    BlendingValues values;
+    zerothOrderBlendingValues(u_knot, values);
+
     blending_values.ResizeColumns(4);
 
-    blending_values(0) = zerothOrderF3(_alpha - u_knot);
-    blending_values(1) = zerothOrderF2(_alpha - u_knot);
-    blending_values(2) = zerothOrderF2(u_knot);
-    blending_values(3) = zerothOrderF3(u_knot);
+    for (GLuint i = 0; i < 4; ++i) {
+        blending_values(i) = values[i];
+    }
 
     return GL_TRUE;
 }
@@ -114,22 +119,15 @@ GLboolean SecondOrderHyperbolicPatch::CalculatePartialDerivatives(
         return GL_FALSE;
     }
 
-    RowMatrix<GLdouble> u_blending_values(4), v_blending_values(4),
-        d1_u_blending_values(4), d1_v_blending_values(4);
-
-    UBlendingFunctionValues(u, u_blending_values);
-    VBlendingFunctionValues(v, v_blending_values);
-
-    d1_u_blending_values(0) = -firstOrderF3(_alpha - u);
-    d1_u_blending_values(1) = -firstOrderF2(_alpha - u);
-    d1_u_blending_values(2) = firstOrderF2(u);
-    d1_u_blending_values(3) = firstOrderF3(u);
-
-    d1_v_blending_values(0) = -firstOrderF3(_alpha - v);
-    d1_v_blending_values(1) = -firstOrderF2(_alpha - v);
-    d1_v_blending_values(2) = firstOrderF2(v);
-    d1_v_blending_values(3) = firstOrderF3(v);
+    // fixed-size blending vectors live on the stack, so evaluating a surface
+    // point does not touch the heap
+    BlendingValues u_blending_values, v_blending_values, d1_u_blending_values,
+        d1_v_blending_values;
 
+    zerothOrderBlendingValues(u, u_blending_values);
+    zerothOrderBlendingValues(v, v_blending_values);
+    firstOrderBlendingValues(u, d1_u_blending_values);
+    firstOrderBlendingValues(v, d1_v_blending_values);
 
     pd.ResizeRows(2);
     pd.LoadNullVectors();
@@ -137,13 +135,14 @@ GLboolean SecondOrderHyperbolicPatch::CalculatePartialDerivatives(
     for (GLuint row = 0; row < 4; ++row) {
         DCoordinate3 aux_d0_v, aux_d1_v;
         for (GLuint column = 0; column < 4; ++column) {
-            aux_d0_v += _data(row, column) * v_blending_values(column);
-            aux_d1_v += _data(row, column) * d1_v_blending_values(column);
+            const DCoordinate3 &p = _data(row, column);
+            aux_d0_v += p * v_blending_values[column];
+            aux_d1_v += p * d1_v_blending_values[column];
         }
 
-        pd(0, 0) += aux_d0_v * u_blending_values(row);
-        pd(1, 0) += aux_d0_v * d1_u_blending_values(row);
-        pd(1, 1) += aux_d1_v * u_blending_values(row);
+        pd(0, 0) += aux_d0_v * u_blending_values[row];
+        pd(1, 0) += aux_d0_v * d1_u_blending_values[row];
+        pd(1, 1) += aux_d1_v * u_blending_values[row];
     }
 
     return GL_TRUE;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../Core/FixedMatrices.h"
 #include "../Core/TensorProductSurfaces3.h"
 #include <cmath>
 
@@ -9,12 +10,23 @@ class SecondOrderHyperbolicPatch : public TensorProductSurface3
 {
     GLdouble _alpha;
 
+    // coefficients of the blending functions that depend only on the
+    // tension parameter, they are calculated once by the constructor
+    GLdouble _f2_c1, _f2_c2; // F2, the latter is used by its derivative too
+    GLdouble _f3_c;          // 1 / sinh^4(alpha / 2)
+    GLdouble _d1_f2_c;       // coth(alpha / 2) / sinh^3(alpha / 2)
 
     GLdouble zerothOrderF2(GLdouble t) const;
     GLdouble zerothOrderF3(GLdouble t) const;
     GLdouble firstOrderF2(GLdouble t) const;
     GLdouble firstOrderF3(GLdouble t) const;
 
+    // the patch is always bicubic-like: 4 blending functions per direction
+    typedef FixedRowMatrix<GLdouble, 4> BlendingValues;
+
+    GLvoid zerothOrderBlendingValues(GLdouble t, BlendingValues &values) const;
+    GLvoid firstOrderBlendingValues(GLdouble t, BlendingValues &values) const;
+
 public:
     SecondOrderHyperbolicPatch(GLdouble alpha_tension);
 
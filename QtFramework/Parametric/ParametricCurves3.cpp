@@ -1,4 +1,7 @@
 #include "ParametricCurves3.h"
+#include "../Core/AdaptiveCurveSampling3.h"
+#include "../Core/ArcLengthTables3.h"
+#include "../Core/LinearCombination3.h"
 
 using namespace cagd;
 using namespace std;
@@ -13,6 +16,8 @@ ParametricCurve3::ParametricCurve3(const RowMatrix<Derivative> &derivatives,
     : _u_min(u_min)
     , _u_max(u_max)
     , _derivatives(derivatives)
+    , _arc_length_segment_count(128)
+    , _derivatives_are_thread_safe(GL_FALSE)
 {}
 
 // calculate derivative at parameter u:
@@ -44,12 +49,158 @@ GenericCurve3 *ParametricCurve3::GenerateImage(GLuint div_point_count,
         (*result)(order, div_point_count - 1) = _derivatives[order](_u_max);
     }
 
-    // calculate derivatives at inner curve points
-    GLdouble u_step = (_u_max - _u_min) / (div_point_count - 1);
-    GLdouble u      = _u_min;
+    // calculate derivatives at inner curve points, u_i is calculated from its
+    // index, thus the points can be evaluated by multiple threads
+    GLdouble  u_step      = (_u_max - _u_min) / (div_point_count - 1);
+    GLint     point_count = (GLint)div_point_count;
+    GLboolean in_parallel =
+        div_point_count >= LinearCombination3::_parallel_image_point_count &&
+        _derivatives_are_thread_safe;
 
-    for (GLuint i = 1; i < div_point_count - 1; i++) {
-        u += u_step;
+#pragma omp parallel for schedule(static) if (in_parallel)
+    for (GLint i = 1; i < point_count - 1; i++) {
+        GLdouble u = _u_min + i * u_step;
+
+        for (GLuint order = 0; order < _derivatives.GetColumnCount(); ++order) {
+            (*result)(order, i) = _derivatives[order](u);
+        }
+    }
+
+    return result;
+}
+
+// evaluator of the given derivatives up to the given order for the adaptive
+// sampler and for the arc length table
+class ParametricCurveEvaluator3
+{
+protected:
+    const RowMatrix<ParametricCurve3::Derivative> &_derivatives;
+    GLuint                                         _order;
+
+public:
+    ParametricCurveEvaluator3(
+        const RowMatrix<ParametricCurve3::Derivative> &derivatives,
+        GLuint                                         order)
+        : _derivatives(derivatives)
+        , _order(order)
+    {}
+
+    GLboolean operator()(GLdouble u, DCoordinate3 *d) const
+    {
+        for (GLuint order = 0; order <= _order; ++order) {
+            d[order] = _derivatives[order](u);
+        }
+        return GL_TRUE;
+    }
+};
+
+// generate image of the parametric curve with curvature-adaptive point spacing
+GenericCurve3 *ParametricCurve3::GenerateAdaptiveImage(
+    GLdouble chord_tolerance, GLuint initial_div_point_count,
+    GLuint maximum_point_count, GLenum usage_flag) const
+{
+    GLuint max_order_of_derivatives = _derivatives.GetColumnCount() - 1;
+
+    ParametricCurveEvaluator3 evaluator(_derivatives, max_order_of_derivatives);
+    AdaptiveCurveSampler3<ParametricCurveEvaluator3> sampler(
+        evaluator, max_order_of_derivatives);
+
+    return sampler.GenerateImage(max_order_of_derivatives, _u_min, _u_max,
+                                 chord_tolerance, initial_div_point_count,
+                                 maximum_point_count, usage_flag);
+}
+
+// arc length parametrization
+GLboolean ParametricCurve3::_UpdateArcLengthTable() const
+{
+    if (_derivatives.GetColumnCount() < 2) {
+        return GL_FALSE;
+    }
+
+    if (_arc_length_table &&
+        _arc_length_table->GetSegmentCount() == _arc_length_segment_count) {
+        return GL_TRUE;
+    }
+
+    std::shared_ptr<ArcLengthTable3> table(new ArcLengthTable3());
+
+    if (!table->Update(ParametricCurveEvaluator3(_derivatives, 1), _u_min,
+                       _u_max, _arc_length_segment_count)) {
+        _arc_length_table.reset();
+        return GL_FALSE;
+    }
+
+    _arc_length_table = table;
+
+    return GL_TRUE;
+}
+
+GLvoid ParametricCurve3::SetArcLengthSegmentCount(GLuint segment_count)
+{
+    _arc_length_segment_count = std::max(segment_count, 1u);
+}
+
+GLboolean ParametricCurve3::GetArcLength(GLdouble &length) const
+{
+    if (!_UpdateArcLengthTable()) {
+        return GL_FALSE;
+    }
+
+    length = _arc_length_table->GetLength();
+
+    return GL_TRUE;
+}
+
+GLboolean ParametricCurve3::ArcLengthAtParameter(GLdouble u, GLdouble &s) const
+{
+    if (!_UpdateArcLengthTable()) {
+        return GL_FALSE;
+    }
+
+    return _arc_length_table->ArcLengthAtParameter(
+        ParametricCurveEvaluator3(_derivatives, 1), u, s);
+}
+
+GLboolean ParametricCurve3::ParameterAtArcLength(GLdouble s, GLdouble &u) const
+{
+    if (!_UpdateArcLengthTable()) {
+        return GL_FALSE;
+    }
+
+    return _arc_length_table->ParameterAtArcLength(
+        ParametricCurveEvaluator3(_derivatives, 1), s, u);
+}
+
+// generate image of the parametric curve at equal arc lengths
+GenericCurve3 *ParametricCurve3::GenerateArcLengthImage(GLuint div_point_count,
+                                                        GLenum usage_flag) const
+{
+    if (div_point_count < 2 || !_UpdateArcLengthTable()) {
+        return nullptr;
+    }
+
+    GenericCurve3 *result = nullptr;
+
+    result = new GenericCurve3(_derivatives.GetColumnCount() - 1,
+                               div_point_count, usage_flag);
+
+    if (!result) {
+        return nullptr;
+    }
+
+    ParametricCurveEvaluator3 evaluator(_derivatives, 1);
+
+    GLdouble length = _arc_length_table->GetLength();
+    GLdouble s_step = length / (div_point_count - 1);
+
+    for (GLuint i = 0; i < div_point_count; i++) {
+        GLdouble s = (i < div_point_count - 1) ? i * s_step : length;
+        GLdouble u;
+
+        if (!_arc_length_table->ParameterAtArcLength(evaluator, s, u)) {
+            delete result;
+            return nullptr;
+        }
 
         for (GLuint order = 0; order < _derivatives.GetColumnCount(); ++order) {
             (*result)(order, i) = _derivatives[order](u);
@@ -67,6 +218,8 @@ GLvoid ParametricCurve3::SetDefinitionDomain(GLdouble u_min, GLdouble u_max)
     }
     _u_min = u_min;
     _u_max = u_max;
+
+    _arc_length_table.reset();
 }
 
 GLvoid ParametricCurve3::GetDefinitionDomain(GLdouble &u_min,
@@ -81,4 +234,17 @@ GLvoid
 ParametricCurve3::SetDerivatives(const RowMatrix<Derivative> &derivatives)
 {
     _derivatives = derivatives;
+
+    _arc_length_table.reset();
+}
+
+// set/get thread safety of the derivatives
+GLvoid ParametricCurve3::SetThreadSafety(GLboolean derivatives_are_thread_safe)
+{
+    _derivatives_are_thread_safe = derivatives_are_thread_safe;
+}
+
+GLboolean ParametricCurve3::IsThreadSafe() const
+{
+    return _derivatives_are_thread_safe;
 }
@@ -1,12 +1,15 @@
 #pragma once
 
 #include <algorithm>
+#include <memory>
 
 #include "../Core/DCoordinates3.h"
 #include "../Core/GenericCurves3.h"
 #include "../Core/Matrices.h"
 
 namespace cagd {
+class ArcLengthTable3;
+
 //-----------------------
 // class ParametricCurve3
 //-----------------------
@@ -22,6 +25,18 @@ private:
     // derivatives of coordinate functions
     RowMatrix<Derivative> _derivatives;
 
+    // arc length table of the current derivatives and definition domain, it
+    // is built on demand by the arc length queries
+    mutable std::shared_ptr<const ArcLengthTable3> _arc_length_table;
+    GLuint                                         _arc_length_segment_count;
+
+    // set by the user, if the derivatives can be called concurrently
+    GLboolean _derivatives_are_thread_safe;
+
+    // rebuilds the arc length table if needed, the first order derivative
+    // has to be given
+    GLboolean _UpdateArcLengthTable() const;
+
 public:
     // special constructor
     ParametricCurve3(const RowMatrix<Derivative> &derivatives, GLdouble u_min,
@@ -30,15 +45,48 @@ public:
     // calculate derivative at the parameter value u
     DCoordinate3 operator()(GLuint order, GLdouble u) const;
 
-    // generate image/arc
+    // generate image/arc, the points of large images are evaluated by
+    // multiple threads if the derivatives are declared thread-safe
     GenericCurve3 *GenerateImage(GLuint div_point_count,
                                  GLenum usage_flag = GL_STATIC_DRAW) const;
 
+    // generate image/arc with variable point spacing, the uniform grid of
+    // initial_div_point_count points is refined until the chords deviate
+    // from the arc by at most chord_tolerance (or maximum_point_count points
+    // are used); the refinement is driven by the first order derivative too,
+    // if it is given
+    GenericCurve3 *
+    GenerateAdaptiveImage(GLdouble chord_tolerance,
+                          GLuint   initial_div_point_count = 17,
+                          GLuint   maximum_point_count     = 65536,
+                          GLenum   usage_flag = GL_STATIC_DRAW) const;
+
+    // arc length parametrization by a table of segment_count + 1 uniform
+    // subdivision points (see ArcLengthTable3), the first order derivative
+    // has to be given
+    GLvoid    SetArcLengthSegmentCount(GLuint segment_count);
+    GLboolean GetArcLength(GLdouble &length) const;
+    GLboolean ArcLengthAtParameter(GLdouble u, GLdouble &s) const;
+    GLboolean ParameterAtArcLength(GLdouble s, GLdouble &u) const;
+
+    // generate image/arc of points at equal arc lengths, the derivatives are
+    // taken w.r.t. the original parameter
+    GenericCurve3 *
+    GenerateArcLengthImage(GLuint div_point_count,
+                           GLenum usage_flag = GL_STATIC_DRAW) const;
+
     // set/get definition domain
     GLvoid SetDefinitionDomain(GLdouble u_min, GLdouble u_max);
     GLvoid GetDefinitionDomain(GLdouble &u_min, GLdouble &u_max) const;
 
     // set derivatives
     GLvoid SetDerivatives(const RowMatrix<Derivative> &derivatives);
+
+    // The derivatives are arbitrary functions, thus GenerateImage calls them
+    // from a single thread, unless they are declared to be safe to call
+    // concurrently (e.g., they do not modify global state). By default they
+    // are not.
+    GLvoid    SetThreadSafety(GLboolean derivatives_are_thread_safe);
+    GLboolean IsThreadSafe() const;
 };
 } // namespace cagd
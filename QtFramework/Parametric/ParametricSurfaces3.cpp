@@ -1,4 +1,5 @@
 #include "ParametricSurfaces3.h"
+#include "../Core/CoordinateArrays3.h"
 
 #include <cmath>
 #include <cstdlib>
@@ -55,6 +56,11 @@ TriangulatedMesh3 *ParametricSurface3::GenerateImage(GLuint u_div_point_count,
     // current triangular face counter
     GLuint current_face = 0;
 
+    // first order partial derivatives, the unit normals are calculated from
+    // them by batch kernels, in double precision
+    DCoordinateArray3 du_partials(u_div_point_count * v_div_point_count);
+    DCoordinateArray3 dv_partials(u_div_point_count * v_div_point_count);
+
     for (GLuint i = 0; i < u_div_point_count; ++i) {
         GLdouble u = min(_u_min + i * du, _u_max);
         GLdouble s = min(i * ds, 1.0);
@@ -78,13 +84,12 @@ TriangulatedMesh3 *ParametricSurface3::GenerateImage(GLuint u_div_point_count,
             index[3] = index[2] - 1;
 
             // surface point
-            (*result)._vertex[index[0]] = _pd(0, 0)(u, v);
+            (*result)._vertex[index[0]] = FCoordinate3(_pd(0, 0)(u, v));
 
-            // the surface normal is obtained as the cross product of the first
-            // order partial derivatives
-            (*result)._normal[index[0]] = _pd(1, 0)(u, v);
-            (*result)._normal[index[0]] ^= _pd(1, 1)(u, v);
-            (*result)._normal[index[0]].normalize();
+            // the surface normal is the cross product of the first order
+            // partial derivatives
+            du_partials.Set(index[0], _pd(1, 0)(u, v));
+            dv_partials.Set(index[0], _pd(1, 1)(u, v));
 
             // texture coordinates
             (*result)._tex[index[0]].s() = (GLfloat)s;
@@ -105,6 +110,11 @@ TriangulatedMesh3 *ParametricSurface3::GenerateImage(GLuint u_div_point_count,
         }
     }
 
+    // unit surface normals
+    CrossAll(du_partials, dv_partials, du_partials);
+    NormalizeAll(du_partials);
+    du_partials.Scatter(&(*result)._normal[0]);
+
     return result;
 }
 } // namespace cagd
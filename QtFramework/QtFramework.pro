@@ -42,6 +42,17 @@ unix {
     LIBS += -lGLEW -lGLU
 }
 
+linux {
+    # OpenMP is used by the LU decomposition (the msvc build enables it above)
+    QMAKE_CXXFLAGS += -fopenmp
+    LIBS += -fopenmp
+}
+
+# uncomment to pad DCoordinate3 to four doubles and to evaluate its operators
+# with SSE2/AVX intrinsics (requires the corresponding -msse2/-mavx/-mavx2 or
+# -arch:AVX/-arch:AVX2 compiler flags), see Core/DCoordinates3.h
+#DEFINES += CAGD_SIMD_DCOORDINATE3
+
 FORMS += \
     GUI/MainWindow.ui \
     GUI/SideWidget.ui
@@ -52,14 +63,23 @@ HEADERS += \
     GUI/SideWidget.h \
     Core/Exceptions.h \
     Core/RealSquareMatrices.h \
+    Core/BandedSquareMatrices.h \
+    Core/FastFourierTransforms.h \
     Core/Matrices.h \
+    Core/FixedMatrices.h \
     Core/DCoordinates3.h \
+    Core/CoordinateArrays3.h \
+    Core/AdaptiveCurveSampling3.h \
+    Core/ArcLengthTables3.h \
     Core/LinearCombination3.h \
+    Core/LinearCombinationEngine3.h \
+    Core/CurveBatches3.h \
     Core/GenericCurves3.h \
     Core/Constants.h \
     Parametric/ParametricCurves3.h \
     Test/TestFunctions.h \
     Cyclic/CyclicCurves3.h \
+    BSpline/BSplineCurves3.h \
     Core/TriangulatedMeshes3.h \
     Core/TriangularFaces.h \
     Core/TCoordinates4.h \
@@ -78,11 +98,15 @@ SOURCES += \
     GUI/SideWidget.cpp \
     main.cpp \
     Core/RealSquareMatrices.cpp \
+    Core/BandedSquareMatrices.cpp \
+    Core/FastFourierTransforms.cpp \
     Core/LinearCombination3.cpp \
     Core/GenericCurves3.cpp \
+    Core/CurveBatches3.cpp \
     Parametric/ParametricCurves3.cpp \
     Test/TestFunctions.cpp \
     Cyclic/CyclicCurves3.cpp \
+    BSpline/BSplineCurves3.cpp \
     Core/TriangulatedMeshes3.cpp \
     Core/Materials.cpp \
     Core/Lights.cpp \
@@ -0,0 +1,354 @@
+// Counts the heap allocations of moves, of the tessellation paths and of the
+// linear solvers by replacing the global operators new and new[], including
+// their aligned versions. The geometric objects are used without an OpenGL
+// context, i.e., no vertex buffer objects are created. The program returns
+// EXIT_FAILURE if an allocation count exceeds its limit. The limits state
+// the intended behavior, not the counts measured today: moves do not
+// allocate, while images and solves allocate a constant number of objects,
+// which does not depend on the number of points or on the size of the system.
+
+#include "../../BSpline/BSplineCurves3.h"
+#include "../../Core/GenericCurves3.h"
+#include "../../Core/Matrices.h"
+#include "../../Core/RealSquareMatrices.h"
+#include "../../Core/TriangulatedMeshes3.h"
+#include "../../Cyclic/CyclicCurves3.h"
+#include "../../Hyperbolic/SecondOrderHyperbolicPatch.h"
+#include "../../Parametric/ParametricCurves3.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+using namespace cagd;
+using namespace std;
+
+namespace {
+// the images are evaluated by multiple threads
+atomic<size_t> allocation_count(0);
+} // namespace
+
+void *operator new(size_t size)
+{
+    ++allocation_count;
+
+    if (void *pointer = malloc(size ? size : 1))
+        return pointer;
+
+    throw bad_alloc();
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void *pointer) noexcept { free(pointer); }
+
+void operator delete(void *pointer, size_t) noexcept { free(pointer); }
+
+void operator delete[](void *pointer) noexcept { free(pointer); }
+
+void operator delete[](void *pointer, size_t) noexcept { free(pointer); }
+
+// over-aligned types, e.g., DCoordinate3 if it is stored in vector registers,
+// are allocated by the aligned versions since C++17
+#ifdef __cpp_aligned_new
+void *operator new(size_t size, align_val_t alignment)
+{
+    ++allocation_count;
+
+    size_t bytes = size ? size : 1;
+
+#ifdef _WIN32
+    if (void *pointer = _aligned_malloc(bytes, (size_t)alignment))
+        return pointer;
+#else
+    void *pointer = nullptr;
+    if (!posix_memalign(&pointer, max((size_t)alignment, sizeof(void *)),
+                        bytes))
+        return pointer;
+#endif
+
+    throw bad_alloc();
+}
+
+void *operator new[](size_t size, align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void *pointer, align_val_t) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    free(pointer);
+#endif
+}
+
+void operator delete(void *pointer, size_t, align_val_t alignment) noexcept
+{
+    operator delete(pointer, alignment);
+}
+
+void operator delete[](void *pointer, align_val_t alignment) noexcept
+{
+    operator delete(pointer, alignment);
+}
+
+void operator delete[](void *pointer, size_t, align_val_t alignment) noexcept
+{
+    operator delete(pointer, alignment);
+}
+#endif
+
+namespace {
+GLuint failure_count = 0;
+
+// An image consists of a few objects (e.g., the curve or the mesh, the
+// matrices of its derivatives or of its vertices, normals and faces, and the
+// workspace of the evaluation), which are allocated as a whole, not point
+// by point. The limit is the same for every number of points.
+const size_t image_allocation_limit = 16;
+
+// A solve allocates at most one workspace for every block of at most
+// LUFactorization::_rhs_block_width (32) right-hand sides, and copying b
+// into x reuses the storage of x, whatever the size of the system.
+const size_t solve_allocation_limit = 1;
+
+template <class Function>
+size_t CountAllocations(Function function)
+{
+    size_t before = allocation_count;
+    function();
+    return allocation_count - before;
+}
+
+GLvoid Check(const char *test_name, size_t count, size_t maximum_count)
+{
+    GLboolean failed = count > maximum_count;
+
+    printf("%-58s %6u allocations, at most %u expected%s\n", test_name,
+           (GLuint)count, (GLuint)maximum_count, failed ? "  FAILED" : "");
+
+    if (failed)
+        ++failure_count;
+}
+
+// derivatives of a helix
+DCoordinate3 HelixD0(GLdouble u) { return DCoordinate3(cos(u), sin(u), u); }
+DCoordinate3 HelixD1(GLdouble u) { return DCoordinate3(-sin(u), cos(u), 1.0); }
+DCoordinate3 HelixD2(GLdouble u) { return DCoordinate3(-cos(u), -sin(u), 0.0); }
+
+//------
+// moves
+//------
+GLvoid TestMoves()
+{
+    Matrix<DCoordinate3> matrix(100, 100);
+    Check("Matrix<DCoordinate3> move constructor",
+          CountAllocations([&] { Matrix<DCoordinate3> m(std::move(matrix)); }),
+          0);
+
+    GenericCurve3 curve(2, 1000);
+    GenericCurve3 other_curve;
+    Check("GenericCurve3 move assignment",
+          CountAllocations([&] { other_curve = std::move(curve); }), 0);
+
+    TriangulatedMesh3 mesh(1000, 2000);
+    Check("TriangulatedMesh3 move constructor",
+          CountAllocations([&] { TriangulatedMesh3 m(std::move(mesh)); }), 0);
+
+    CyclicCurve3 cyclic_curve(10);
+    Check("CyclicCurve3 move constructor", CountAllocations([&] {
+              CyclicCurve3 c(std::move(cyclic_curve));
+          }),
+          0);
+
+    RealSquareMatrix square_matrix(100);
+    Check("RealSquareMatrix move constructor", CountAllocations([&] {
+              RealSquareMatrix m(std::move(square_matrix));
+          }),
+          0);
+}
+
+//-------------------------------------------------------------------------
+// images: the number of allocations may not depend on the number of points,
+// i.e., the points are not allocated or copied one by one
+//-------------------------------------------------------------------------
+template <class Curve>
+GLvoid TestCurveImage(const char *curve_name, const Curve &curve,
+                      GLuint max_order_of_derivatives)
+{
+    const GLuint div_point_counts[2] = {100, 10000};
+
+    for (GLuint i = 0; i < 2; ++i) {
+        GenericCurve3 *image = nullptr;
+
+        // the first call may update the caches of the curve
+        delete curve.GenerateImage(max_order_of_derivatives,
+                                   div_point_counts[i]);
+
+        size_t count = CountAllocations([&] {
+            image = curve.GenerateImage(max_order_of_derivatives,
+                                        div_point_counts[i]);
+        });
+
+        delete image;
+
+        char test_name[64];
+        snprintf(test_name, sizeof(test_name), "%s::GenerateImage, %u points",
+                 curve_name, div_point_counts[i]);
+        Check(test_name, count, image_allocation_limit);
+    }
+}
+
+GLvoid TestImages()
+{
+    CyclicCurve3 cyclic_curve(5);
+    for (GLuint i = 0; i < cyclic_curve.GetDataCount(); ++i)
+        cyclic_curve[i] = DCoordinate3(cos(i), sin(i), 0.1 * i);
+    TestCurveImage("CyclicCurve3", cyclic_curve, 2);
+
+    BSplineCurve3 b_spline_curve(3, 20);
+    for (GLuint i = 0; i < b_spline_curve.GetDataCount(); ++i)
+        b_spline_curve[i] = DCoordinate3(i, sin(i), 0.0);
+    TestCurveImage("BSplineCurve3", b_spline_curve, 2);
+
+    RowMatrix<ParametricCurve3::Derivative> derivatives(3);
+    derivatives[0] = HelixD0;
+    derivatives[1] = HelixD1;
+    derivatives[2] = HelixD2;
+
+    ParametricCurve3 helix(derivatives, 0.0, 6.0 * acos(-1.0));
+    const GLuint     div_point_counts[2] = {100, 10000};
+
+    for (GLuint i = 0; i < 2; ++i) {
+        GenericCurve3 *image = nullptr;
+        size_t         count = CountAllocations(
+            [&] { image = helix.GenerateImage(div_point_counts[i]); });
+        delete image;
+
+        char test_name[64];
+        snprintf(test_name, sizeof(test_name),
+                 "ParametricCurve3::GenerateImage, %u points",
+                 div_point_counts[i]);
+        Check(test_name, count, image_allocation_limit);
+    }
+}
+
+//------------------------------------------
+// surfaces: partial derivatives and meshes
+//------------------------------------------
+GLvoid TestSurfaces()
+{
+    SecondOrderHyperbolicPatch patch(1.0);
+
+    for (GLuint i = 0; i < 4; ++i)
+        for (GLuint j = 0; j < 4; ++j)
+            patch(i, j) = DCoordinate3(i, j, sin(i + j));
+
+    TensorProductSurface3::PartialDerivatives pd(1);
+
+    patch.CalculatePartialDerivatives(1, 0.5, 0.5, pd);
+
+    Check("SecondOrderHyperbolicPatch::CalculatePartialDerivatives",
+          CountAllocations([&] {
+              for (GLuint k = 0; k < 1000; ++k)
+                  patch.CalculatePartialDerivatives(1, 0.001 * k, 0.5, pd);
+          }),
+          0);
+
+    GLuint div_point_counts[2] = {10, 100};
+
+    for (GLuint i = 0; i < 2; ++i) {
+        TriangulatedMesh3 *mesh  = nullptr;
+        size_t             count = CountAllocations([&] {
+            mesh = patch.GenerateImage(div_point_counts[i],
+                                       div_point_counts[i]);
+        });
+        delete mesh;
+
+        char test_name[64];
+        snprintf(test_name, sizeof(test_name),
+                 "TensorProductSurface3::GenerateImage, %u x %u points",
+                 div_point_counts[i], div_point_counts[i]);
+        Check(test_name, count, image_allocation_limit);
+    }
+}
+
+//-------------------------------------------------------------------------
+// linear systems: the right-hand sides are copied into x, whose storage is
+// reused if it has their size, and they are substituted in a workspace whose
+// number of allocations does not depend on the size of the system
+//-------------------------------------------------------------------------
+GLvoid TestLinearSystems()
+{
+    const GLuint sizes[3] = {10, 100, 500};
+
+    for (GLuint s = 0; s < 3; ++s) {
+        GLuint size = sizes[s];
+
+        RealSquareMatrix A(size);
+        for (GLuint i = 0; i < size; ++i)
+            for (GLuint j = 0; j < size; ++j)
+                A(i, j) = (i == j) ? 2.0 * size : 1.0 / (1.0 + i + j);
+
+        Matrix<DCoordinate3> b(size, 4), x(size, 4);
+        for (GLuint i = 0; i < size; ++i)
+            for (GLuint k = 0; k < 4; ++k)
+                b(i, k) = DCoordinate3(i, k, 1.0);
+
+        A.PerformLUDecomposition();
+
+        shared_ptr<const LUFactorization> lu = A.GetLUFactorization();
+
+        char test_name[64];
+
+        snprintf(test_name, sizeof(test_name),
+                 "RealSquareMatrix::SolveLinearSystem, size %u, in place",
+                 size);
+        Check(test_name,
+              CountAllocations([&] { A.SolveLinearSystem(x.GetBlockView()); }),
+              solve_allocation_limit);
+
+        snprintf(test_name, sizeof(test_name),
+                 "RealSquareMatrix::SolveLinearSystem, size %u, x = b", size);
+        Check(test_name, CountAllocations([&] { A.SolveLinearSystem(b, x); }),
+              solve_allocation_limit);
+
+        snprintf(test_name, sizeof(test_name),
+                 "LUFactorization::Solve, size %u, in place", size);
+        Check(test_name,
+              CountAllocations([&] { lu->Solve(x.GetBlockView()); }),
+              solve_allocation_limit);
+
+        snprintf(test_name, sizeof(test_name),
+                 "LUFactorization::Solve, size %u, x = b", size);
+        Check(test_name, CountAllocations([&] { lu->Solve(b, x); }),
+              solve_allocation_limit);
+    }
+}
+} // namespace
+
+int main()
+{
+    TestMoves();
+    TestImages();
+    TestSurfaces();
+    TestLinearSystems();
+
+    if (failure_count) {
+        printf("%u test(s) failed\n", failure_count);
+        return EXIT_FAILURE;
+    }
+
+    printf("all tests passed\n");
+
+    return EXIT_SUCCESS;
+}
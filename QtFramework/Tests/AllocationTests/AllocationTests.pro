@@ -0,0 +1,7 @@
+# counts the heap allocations of moves, images and linear solvers, the
+# program fails if a count exceeds its bound
+include(../Tests.pri)
+
+TARGET = AllocationTests
+
+SOURCES += AllocationTests.cpp
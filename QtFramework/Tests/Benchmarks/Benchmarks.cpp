@@ -0,0 +1,55 @@
+// Runs the benchmarks whose names are given as arguments, or all of them.
+// The timings are the minima of several runs, in milliseconds unless noted
+// otherwise, and they are only meaningful in release builds.
+
+#include "Benchmarks.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace cagd;
+using namespace cagd::benchmarks;
+
+volatile GLdouble cagd::benchmarks::sink = 0.0;
+
+namespace {
+struct Benchmark
+{
+    const char *name;
+    GLvoid (*run)();
+};
+
+const Benchmark benchmark_list[] = {
+    {"storage", RunStorageBenchmark},
+    {"partial-derivatives", RunPartialDerivativesBenchmark},
+    {"hyperbolic-patch", RunHyperbolicPatchBenchmark},
+    {"lu-decomposition", RunLUDecompositionBenchmark},
+    {"multiple-right-hand-sides", RunMultipleRightHandSidesBenchmark},
+    {"coordinate-kernels", RunCoordinateKernelsBenchmark},
+    {"cyclic-fourier", RunCyclicFourierBenchmark},
+    {"image-scaling", RunImageScalingBenchmark},
+    {"drag", RunDragBenchmark},
+};
+
+const GLuint benchmark_count = sizeof(benchmark_list) / sizeof(Benchmark);
+} // namespace
+
+int main(int argc, char **argv)
+{
+    for (GLuint i = 0; i < benchmark_count; ++i) {
+        GLboolean selected = (argc == 1);
+
+        for (int j = 1; j < argc; ++j)
+            selected |= !strcmp(argv[j], benchmark_list[i].name);
+
+        if (selected) {
+            printf("--- %s\n", benchmark_list[i].name);
+            benchmark_list[i].run();
+        }
+    }
+
+    printf("(checksum %g)\n", (GLdouble)sink);
+
+    return EXIT_SUCCESS;
+}
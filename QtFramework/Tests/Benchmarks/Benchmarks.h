@@ -0,0 +1,61 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace cagd {
+namespace benchmarks {
+// The shortest wall clock time of several runs of the given function, in
+// milliseconds. The minimum is the least disturbed by other processes.
+template <class Function>
+GLdouble MinimumTime(GLuint run_count, Function function)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    GLdouble minimum = std::numeric_limits<GLdouble>::max();
+
+    for (GLuint run = 0; run < run_count; ++run) {
+        Clock::time_point start = Clock::now();
+        function();
+        std::chrono::duration<GLdouble, std::milli> elapsed =
+            Clock::now() - start;
+        minimum = std::min(minimum, elapsed.count());
+    }
+
+    return minimum;
+}
+
+// Results that the compiler could otherwise discard are accumulated here,
+// the sum is printed by the main program.
+extern volatile GLdouble sink;
+
+// construction, copy and traversal of Matrix<GLdouble>
+GLvoid RunStorageBenchmark();
+
+// construction of partial derivatives, isoparametric lines and meshes
+GLvoid RunPartialDerivativesBenchmark();
+
+// blending functions and partial derivatives of a hyperbolic patch
+GLvoid RunHyperbolicPatchBenchmark();
+
+// LU decomposition of matrices of size 16 to 4096 by 1 to N threads
+GLvoid RunLUDecompositionBenchmark();
+
+// substitution of 1 to 256 right-hand sides, systems of size 4 to 512
+GLvoid RunMultipleRightHandSidesBenchmark();
+
+// DCoordinate3 arithmetic, vertex normals and tensor product surfaces
+GLvoid RunCoordinateKernelsBenchmark();
+
+// cyclic curves of order 2 to 500 by Clenshaw's recurrence and directly
+GLvoid RunCyclicFourierBenchmark();
+
+// cyclic, B-spline and parametric images of 10^3 to 10^7 points
+GLvoid RunImageScalingBenchmark();
+
+// frame times of dragging a control point of cyclic and B-spline curves
+GLvoid RunDragBenchmark();
+} // namespace benchmarks
+} // namespace cagd
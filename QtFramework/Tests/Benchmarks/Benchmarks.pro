@@ -0,0 +1,19 @@
+# timings of the performance critical parts of the framework, run
+# Benchmarks [name ...] to select some of them
+include(../Tests.pri)
+
+TARGET = Benchmarks
+
+HEADERS += Benchmarks.h
+
+SOURCES += \
+    Benchmarks.cpp \
+    StorageBenchmark.cpp \
+    PartialDerivativesBenchmark.cpp \
+    HyperbolicPatchBenchmark.cpp \
+    LUDecompositionBenchmark.cpp \
+    MultipleRightHandSidesBenchmark.cpp \
+    CoordinateKernelsBenchmark.cpp \
+    CyclicFourierBenchmark.cpp \
+    ImageScalingBenchmark.cpp \
+    DragBenchmark.cpp
@@ -0,0 +1,139 @@
+// The hot loops over DCoordinate3 whose speed depends on the representation
+// selected by CAGD_SIMD_DCOORDINATE3: element-wise operations over arrays,
+// the accumulation and normalization of vertex normals over a triangulated
+// grid, and the evaluation of tensor product surfaces. Compare the builds
+// with and without DEFINES += CAGD_SIMD_DCOORDINATE3 (and -mavx or -mavx2).
+
+#include "Benchmarks.h"
+
+#include "../../Core/DCoordinates3.h"
+#include "../../Core/TriangulatedMeshes3.h"
+#include "../../Hyperbolic/SecondOrderHyperbolicPatch.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace cagd;
+using namespace std;
+
+GLvoid cagd::benchmarks::RunCoordinateKernelsBenchmark()
+{
+#if defined(CAGD_DCOORDINATE3_AVX)
+    printf("DCoordinate3: 4 doubles, AVX\n");
+#elif defined(CAGD_DCOORDINATE3_SSE2)
+    printf("DCoordinate3: 4 doubles, SSE2\n");
+#else
+    printf("DCoordinate3: %u doubles, scalar\n",
+           (GLuint)(sizeof(DCoordinate3) / sizeof(GLdouble)));
+#endif
+
+    // n x n grid, its vertices and triangular faces
+    const GLuint n            = 256;
+    const GLuint vertex_count = n * n;
+
+    vector<DCoordinate3> vertex(vertex_count), normal(vertex_count),
+        other(vertex_count);
+    vector<GLuint> face;
+
+    for (GLuint i = 0; i < n; ++i)
+        for (GLuint j = 0; j < n; ++j) {
+            vertex[i * n + j] = DCoordinate3(i, j, sin(0.1 * i) * cos(0.1 * j));
+            other[i * n + j]  = DCoordinate3(j, 1.0, 0.5 * i);
+        }
+
+    for (GLuint i = 0; i + 1 < n; ++i)
+        for (GLuint j = 0; j + 1 < n; ++j) {
+            GLuint v = i * n + j;
+            face.push_back(v);
+            face.push_back(v + 1);
+            face.push_back(v + n);
+            face.push_back(v + 1);
+            face.push_back(v + n + 1);
+            face.push_back(v + n);
+        }
+
+    printf("%-44s %12s\n", "arrays of 65536 coordinates", "ns/element");
+
+    GLdouble time = MinimumTime(10, [&] {
+        for (GLuint i = 0; i < vertex_count; ++i)
+            normal[i] += other[i] * 0.5;
+        sink = sink + normal[vertex_count - 1][2];
+    });
+    printf("  a += b * s %43.3f\n", time * 1.0e6 / vertex_count);
+
+    time = MinimumTime(10, [&] {
+        GLdouble sum = 0.0;
+        for (GLuint i = 0; i < vertex_count; ++i)
+            sum += vertex[i] * other[i];
+        sink = sink + sum;
+    });
+    printf("  dot product %42.3f\n", time * 1.0e6 / vertex_count);
+
+    time = MinimumTime(10, [&] {
+        for (GLuint i = 0; i < vertex_count; ++i)
+            normal[i] = vertex[i] ^ other[i];
+        sink = sink + normal[vertex_count - 1][0];
+    });
+    printf("  cross product %40.3f\n", time * 1.0e6 / vertex_count);
+
+    time = MinimumTime(10, [&] {
+        for (GLuint i = 0; i < vertex_count; ++i)
+            normal[i].normalize();
+        sink = sink + normal[vertex_count - 1][1];
+    });
+    printf("  normalize %44.3f\n", time * 1.0e6 / vertex_count);
+
+    // the face normals are added to the normals of their vertices, which are
+    // normalized afterwards, as by TriangulatedMesh3::LoadFromOFF
+    time = MinimumTime(10, [&] {
+        for (GLuint i = 0; i < vertex_count; ++i)
+            normal[i] = DCoordinate3();
+
+        for (GLuint f = 0; f < face.size(); f += 3) {
+            const DCoordinate3 &v0 = vertex[face[f]];
+            DCoordinate3        e1 = vertex[face[f + 1]] - v0;
+            DCoordinate3        e2 = vertex[face[f + 2]] - v0;
+            DCoordinate3        n0 = e1 ^ e2;
+
+            normal[face[f]] += n0;
+            normal[face[f + 1]] += n0;
+            normal[face[f + 2]] += n0;
+        }
+
+        for (GLuint i = 0; i < vertex_count; ++i)
+            normal[i].normalize();
+
+        sink = sink + normal[vertex_count / 2][2];
+    });
+    printf("%-44s %12s\n", "vertex normals of the 256 x 256 grid", "ms");
+    printf("  accumulate and normalize %29.3f\n", time);
+
+    SecondOrderHyperbolicPatch patch(1.0);
+
+    for (GLuint i = 0; i < 4; ++i)
+        for (GLuint j = 0; j < 4; ++j)
+            patch(i, j) = DCoordinate3(i, j, sin(0.5 * (i + j)));
+
+    TensorProductSurface3::PartialDerivatives pd(1);
+
+    const GLuint point_count = 100000;
+
+    time = MinimumTime(5, [&] {
+        for (GLuint k = 0; k < point_count; ++k) {
+            patch.CalculatePartialDerivatives(1, (GLdouble)k / point_count,
+                                              0.5, pd);
+            sink = sink + pd(1, 1)[2];
+        }
+    });
+    printf("%-44s %12s\n", "hyperbolic patch", "");
+    printf("  partial derivatives, order 1, ns/point %15.1f\n",
+           time * 1.0e6 / point_count);
+
+    time = MinimumTime(5, [&] {
+        TriangulatedMesh3 *mesh = patch.GenerateImage(200, 200);
+        sink = sink + mesh->VertexCount();
+        delete mesh;
+    });
+    printf("  mesh of 200 x 200 points, ms %25.3f\n", time);
+}
@@ -0,0 +1,120 @@
+// Evaluation of cyclic curves of order 2 to 500, up to their third order
+// derivatives: Clenshaw's recurrence over the cached Fourier coefficients
+// used by CyclicCurve3, compared to the direct O(n^2) sum over the control
+// points that the curve evaluated before, with its pow and cos calls.
+
+#include "Benchmarks.h"
+
+#include "../../Core/Constants.h"
+#include "../../Cyclic/CyclicCurves3.h"
+
+#include <cmath>
+#include <cstdio>
+
+using namespace cagd;
+using namespace cagd::benchmarks;
+
+namespace {
+// the former CyclicCurve3::CalculateDerivatives
+GLvoid DirectDerivatives(const CyclicCurve3 &curve, GLuint n,
+                         GLuint max_order_of_derivatives, GLdouble u,
+                         LinearCombination3::Derivatives &d)
+{
+    std::shared_ptr<const CyclicCurve3::Tables> tables =
+        CyclicCurve3::GetTables(n);
+
+    for (GLuint r = 0; r <= max_order_of_derivatives; ++r) {
+        d[r] = DCoordinate3();
+    }
+
+    DCoordinate3 centroid;
+
+    for (GLuint i = 0; i <= 2 * n; ++i) {
+        centroid += curve[i];
+    }
+
+    centroid /= (GLdouble)(2 * n + 1);
+
+    for (GLuint r = 0; r <= max_order_of_derivatives; ++r) {
+        for (GLuint i = 0; i <= 2 * n; ++i) {
+            GLdouble sum_k = 0.0;
+
+            for (GLuint k = 0; k <= n - 1; ++k) {
+                sum_k += pow(n - k, (GLint)r) * tables->binomial[k] *
+                         cos((n - k) * (u - i * tables->lambda_n) +
+                             r * PI / 2.0);
+            }
+
+            d[r] += sum_k * curve[i];
+        }
+        d[r] *= 2.0;
+        d[r] /= (GLdouble)(2 * n + 1);
+        d[r] /= tables->binomial[n];
+    }
+    d[0] += centroid;
+}
+} // namespace
+
+GLvoid cagd::benchmarks::RunCyclicFourierBenchmark()
+{
+    const GLuint max_order_of_derivatives = 3;
+    const GLuint order[]                  = {2, 5, 10, 50, 100, 200, 500};
+
+    printf("%-32s %10s %10s %10s\n", "us per evaluation, orders 0..3",
+           "direct", "Clenshaw", "max error");
+
+    for (GLuint o = 0; o < sizeof(order) / sizeof(GLuint); ++o) {
+        GLuint n = order[o];
+
+        CyclicCurve3 curve(n);
+        for (GLuint i = 0; i <= 2 * n; ++i) {
+            GLdouble t = i * TWO_PI / (2 * n + 1);
+            curve[i]   = DCoordinate3(cos(t), sin(2.0 * t), sin(3.0 * t));
+        }
+
+        // the direct sum costs O(n^2) per sample, the sample count keeps the
+        // running time of the large orders bounded
+        GLuint sample_count = std::max(1u, 20000u / (n * n));
+        GLuint run_count    = (n >= 200) ? 2 : 5;
+
+        LinearCombination3::Derivatives direct(max_order_of_derivatives),
+            clenshaw(max_order_of_derivatives);
+
+        GLdouble error = 0.0;
+        for (GLuint k = 0; k < sample_count; ++k) {
+            GLdouble u = k * TWO_PI / sample_count;
+            DirectDerivatives(curve, n, max_order_of_derivatives, u, direct);
+            curve.CalculateDerivatives(max_order_of_derivatives, u, clenshaw);
+
+            for (GLuint r = 0; r <= max_order_of_derivatives; ++r) {
+                DCoordinate3 difference = direct[r] - clenshaw[r];
+                error = std::max(error, difference.length() /
+                                            std::max(1.0, direct[r].length()));
+            }
+        }
+
+        GLdouble direct_time = MinimumTime(run_count, [&] {
+            for (GLuint k = 0; k < sample_count; ++k) {
+                DirectDerivatives(curve, n, max_order_of_derivatives,
+                                  k * TWO_PI / sample_count, direct);
+                sink = sink + direct[max_order_of_derivatives][0];
+            }
+        });
+
+        // Clenshaw's recurrence is cheap enough to evaluate many more samples
+        const GLuint clenshaw_sample_count = 10000;
+
+        GLdouble clenshaw_time = MinimumTime(5, [&] {
+            for (GLuint k = 0; k < clenshaw_sample_count; ++k) {
+                curve.CalculateDerivatives(max_order_of_derivatives,
+                                           k * TWO_PI / clenshaw_sample_count,
+                                           clenshaw);
+                sink = sink + clenshaw[max_order_of_derivatives][0];
+            }
+        });
+
+        printf("  n = %3u %34.3f %10.3f %10.1e\n", n,
+               direct_time * 1.0e3 / sample_count,
+               clenshaw_time * 1.0e3 / clenshaw_sample_count, error);
+    }
+}
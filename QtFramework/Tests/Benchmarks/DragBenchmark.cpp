@@ -0,0 +1,105 @@
+// Frame times of dragging a control point: the control point is moved and
+// the image is updated by UpdateImageIncrementally, compared to moving it
+// and regenerating the whole image by GenerateImage. Cyclic curves of order
+// 5 to 50 and a cubic B-spline curve are sampled with their derivatives up
+// to order 2 at 100 to 10000 points. The size of the image basis of the
+// cyclic curves, i.e., of the blending function derivatives that
+// LinearCombination3 caches up to 8192 kB by default, is given in kB; the
+// B-spline curve visits only the points of the spans of the moved control
+// point instead. The times are given per frame, in microseconds.
+
+#include "Benchmarks.h"
+
+#include "../../BSpline/BSplineCurves3.h"
+#include "../../Core/Constants.h"
+#include "../../Cyclic/CyclicCurves3.h"
+
+#include <cmath>
+#include <cstdio>
+
+using namespace cagd;
+using namespace cagd::benchmarks;
+
+namespace {
+const GLuint max_order_of_derivatives = 2;
+const GLuint frame_count              = 100;
+
+template <class Curve>
+GLvoid DragCurve(const char *name, Curve &curve, GLboolean uses_image_basis)
+{
+    GLuint data_count = curve.GetDataCount();
+
+    for (GLuint i = 0; i < data_count; ++i) {
+        GLdouble u = i * TWO_PI / data_count;
+        curve[i]   = DCoordinate3(cos(u), sin(u), sin(3.0 * u));
+    }
+
+    for (GLuint div_point_count = 100; div_point_count <= 10000;
+         div_point_count *= 10) {
+        char basis_size[16] = "-";
+        if (uses_image_basis)
+            snprintf(basis_size, sizeof(basis_size), "%.0f",
+                     8.0 * (max_order_of_derivatives + 1) * div_point_count *
+                         data_count / 1024.0);
+
+        GenericCurve3 *image =
+            curve.GenerateImage(max_order_of_derivatives, div_point_count);
+
+        // the first frame builds the image basis, if it is cached at all
+        GLuint index = data_count / 2;
+        curve.UpdateImageIncrementally(index, DCoordinate3(0.0, 0.0, 0.01),
+                                       *image);
+
+        GLdouble incremental_time = MinimumTime(3, [&] {
+            for (GLuint f = 0; f < frame_count; ++f) {
+                GLdouble dz = (f % 2) ? -0.01 : 0.01;
+                curve.UpdateImageIncrementally(
+                    index, DCoordinate3(0.0, 0.0, dz), *image);
+            }
+            sink = sink + (*image)(0, div_point_count / 2)[2];
+        });
+
+        GLdouble regeneration_time = MinimumTime(3, [&] {
+            for (GLuint f = 0; f < frame_count; ++f) {
+                GLdouble dz = (f % 2) ? -0.01 : 0.01;
+                curve[index] += DCoordinate3(0.0, 0.0, dz);
+
+                GenericCurve3 *new_image = curve.GenerateImage(
+                    max_order_of_derivatives, div_point_count);
+                sink = sink + (*new_image)(0, div_point_count / 2)[2];
+                delete new_image;
+            }
+        });
+
+        printf("  %-20s %6u %10s %12.1f %12.1f\n", name, div_point_count,
+               basis_size, incremental_time * 1.0e3 / frame_count,
+               regeneration_time * 1.0e3 / frame_count);
+
+        delete image;
+    }
+}
+} // namespace
+
+GLvoid cagd::benchmarks::RunDragBenchmark()
+{
+    printf("  %-20s %6s %10s %12s %12s\n", "curve", "points", "basis kB",
+           "incremental", "regenerate");
+
+    const GLuint order[] = {5, 20, 50};
+
+    for (GLuint o = 0; o < sizeof(order) / sizeof(GLuint); ++o) {
+        char name[32];
+        snprintf(name, sizeof(name), "cyclic, n = %u", order[o]);
+
+        CyclicCurve3 curve(order[o]);
+        DragCurve(name, curve, GL_TRUE);
+    }
+
+    // the largest image bases exceed the default limit
+    CyclicCurve3 large_curve(50);
+    large_curve.SetMaximumImageBasisSize(1u << 24);
+    DragCurve("cyclic, n = 50, 2^24", large_curve, GL_TRUE);
+
+    BSplineCurve3 curve(3, 64);
+    DragCurve("cubic B-spline, 64", curve, GL_FALSE);
+}
@@ -0,0 +1,49 @@
+// Per-point costs of a second order hyperbolic patch: the evaluation of its
+// blending functions and of its partial derivatives up to first order into
+// a reused PartialDerivatives object.
+
+#include "Benchmarks.h"
+
+#include "../../Hyperbolic/SecondOrderHyperbolicPatch.h"
+
+#include <cmath>
+#include <cstdio>
+
+using namespace cagd;
+
+GLvoid cagd::benchmarks::RunHyperbolicPatchBenchmark()
+{
+    const GLuint point_count = 100000;
+
+    SecondOrderHyperbolicPatch patch(1.0);
+
+    for (GLuint i = 0; i < 4; ++i)
+        for (GLuint j = 0; j < 4; ++j)
+            patch(i, j) = DCoordinate3(i, j, sin(0.5 * (i + j)));
+
+    printf("%-44s %12s\n", "hyperbolic patch, per point", "ns");
+
+    RowMatrix<GLdouble> values(4);
+
+    GLdouble time = MinimumTime(5, [&] {
+        for (GLuint k = 0; k < point_count; ++k) {
+            patch.UBlendingFunctionValues((GLdouble)k / point_count, values);
+            sink = sink + values(3);
+        }
+    });
+
+    printf("  UBlendingFunctionValues %30.1f\n", time * 1.0e6 / point_count);
+
+    TensorProductSurface3::PartialDerivatives pd(1);
+
+    time = MinimumTime(5, [&] {
+        for (GLuint k = 0; k < point_count; ++k) {
+            patch.CalculatePartialDerivatives(1, (GLdouble)k / point_count,
+                                              0.5, pd);
+            sink = sink + pd(1, 1)[2];
+        }
+    });
+
+    printf("  CalculatePartialDerivatives, order 1 %17.1f\n",
+           time * 1.0e6 / point_count);
+}
@@ -0,0 +1,112 @@
+// Generation of images of 10^3 to 10^7 points, with their first order
+// derivatives, by a cyclic curve, a cubic B-spline curve and a parametric
+// curve with thread-safe derivatives, by 1 and by N threads. The times are
+// given per point, in nanoseconds, and they should not grow with the size
+// of the image. Repeated images of the same grid are generated from the
+// cached image basis of the cyclic curve, as long as it fits into memory.
+
+#include "Benchmarks.h"
+
+#include "../../BSpline/BSplineCurves3.h"
+#include "../../Core/Constants.h"
+#include "../../Cyclic/CyclicCurves3.h"
+#include "../../Parametric/ParametricCurves3.h"
+
+#include <cmath>
+#include <cstdio>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace cagd;
+using namespace cagd::benchmarks;
+
+namespace {
+// trefoil knot and its first order derivative
+DCoordinate3 Trefoil0(GLdouble u)
+{
+    return DCoordinate3(sin(u) + 2.0 * sin(2.0 * u),
+                        cos(u) - 2.0 * cos(2.0 * u), -sin(3.0 * u));
+}
+
+DCoordinate3 Trefoil1(GLdouble u)
+{
+    return DCoordinate3(cos(u) + 4.0 * cos(2.0 * u),
+                        -sin(u) + 4.0 * sin(2.0 * u), -3.0 * cos(3.0 * u));
+}
+
+// time of a single image of the given size, in nanoseconds per point
+template <class Curve>
+GLdouble ImageTime(const Curve &curve, GLuint div_point_count)
+{
+    return MinimumTime(3, [&] {
+               GenericCurve3 *image = curve.GenerateImage(1, div_point_count);
+               sink = sink + (*image)(1, div_point_count - 1)[0];
+               delete image;
+           }) *
+           1.0e6 / div_point_count;
+}
+
+GLdouble ParametricImageTime(const ParametricCurve3 &curve,
+                             GLuint                  div_point_count)
+{
+    return MinimumTime(3, [&] {
+               GenericCurve3 *image = curve.GenerateImage(div_point_count);
+               sink = sink + (*image)(1, div_point_count - 1)[0];
+               delete image;
+           }) *
+           1.0e6 / div_point_count;
+}
+} // namespace
+
+GLvoid cagd::benchmarks::RunImageScalingBenchmark()
+{
+    GLint max_thread_count = 1;
+#ifdef _OPENMP
+    max_thread_count = omp_get_max_threads();
+#endif
+
+    CyclicCurve3 cyclic(5);
+    for (GLuint i = 0; i < cyclic.GetDataCount(); ++i) {
+        GLdouble u = i * TWO_PI / cyclic.GetDataCount();
+        cyclic[i]  = Trefoil0(u);
+    }
+
+    BSplineCurve3 b_spline(3, 64);
+    for (GLuint i = 0; i < b_spline.GetDataCount(); ++i) {
+        GLdouble u  = i * TWO_PI / b_spline.GetDataCount();
+        b_spline[i] = Trefoil0(u);
+    }
+
+    RowMatrix<ParametricCurve3::Derivative> derivatives(2);
+    derivatives[0] = Trefoil0;
+    derivatives[1] = Trefoil1;
+
+    ParametricCurve3 parametric(derivatives, 0.0, TWO_PI);
+    parametric.SetThreadSafety(GL_TRUE);
+
+    printf("%9s %8s %12s %12s %12s\n", "points", "threads", "cyclic",
+           "B-spline", "parametric");
+
+    for (GLuint div_point_count = 1000; div_point_count <= 10000000;
+         div_point_count *= 10) {
+        // 1 thread and the maximal number of threads
+        for (GLint thread_count = 1;; thread_count = max_thread_count) {
+#ifdef _OPENMP
+            omp_set_num_threads(thread_count);
+#endif
+
+            printf("%9u %8d %12.1f %12.1f %12.1f\n", div_point_count,
+                   thread_count, ImageTime(cyclic, div_point_count),
+                   ImageTime(b_spline, div_point_count),
+                   ParametricImageTime(parametric, div_point_count));
+
+            if (thread_count == max_thread_count)
+                break;
+        }
+    }
+
+#ifdef _OPENMP
+    omp_set_num_threads(max_thread_count);
+#endif
+}
@@ -0,0 +1,77 @@
+// Scaling of RealSquareMatrix::PerformLUDecomposition with the size of the
+// matrix, from 16 to 4096, and with the number of OpenMP threads, from 1 to
+// the number of available ones. Small matrices are decomposed repeatedly,
+// the same random matrix is generated before every decomposition, and its
+// generation is included in the times, which are given per decomposition.
+
+#include "Benchmarks.h"
+
+#include "../../Core/RealSquareMatrices.h"
+
+#include <cstdio>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace cagd;
+
+namespace {
+// the elements are uniformly distributed in [-1, 1] and generated by a
+// linear congruential generator, thus every call yields the same matrix
+GLvoid GenerateMatrix(RealSquareMatrix &a)
+{
+    GLuint seed = 12345;
+
+    for (GLuint i = 0; i < a.GetRowCount(); ++i)
+        for (GLuint j = 0; j < a.GetColumnCount(); ++j) {
+            seed    = 1664525u * seed + 1013904223u;
+            a(i, j) = 2.0 * seed / 4294967295.0 - 1.0;
+        }
+}
+} // namespace
+
+GLvoid cagd::benchmarks::RunLUDecompositionBenchmark()
+{
+    GLint max_thread_count = 1;
+#ifdef _OPENMP
+    max_thread_count = omp_get_max_threads();
+#endif
+
+    printf("%6s %8s %14s %10s\n", "size", "threads", "ms", "GFLOP/s");
+
+    for (GLuint size = 16; size <= 4096; size *= 2) {
+        GLuint repetition_count = std::max(1u, (1u << 24) / size / size / size);
+        GLuint run_count        = size <= 1024 ? 5 : 1;
+
+        // 2 n^3 / 3 floating point operations
+        GLdouble flop_count = 2.0 * size * size * size / 3.0;
+
+        // 1, 2, 4, ... threads, and the maximal number of threads
+        for (GLint thread_count = 1;;
+             thread_count = std::min(2 * thread_count, max_thread_count)) {
+#ifdef _OPENMP
+            omp_set_num_threads(thread_count);
+#endif
+
+            GLdouble time = MinimumTime(run_count, [&] {
+                for (GLuint r = 0; r < repetition_count; ++r) {
+                    RealSquareMatrix a(size);
+                    GenerateMatrix(a);
+                    a.PerformLUDecomposition();
+                    sink = sink + a(size - 1, size - 1);
+                }
+            }) / repetition_count;
+
+            printf("%6u %8d %14.4f %10.2f\n", size, thread_count, time,
+                   flop_count / time * 1.0e-6);
+
+            if (thread_count == max_thread_count)
+                break;
+        }
+    }
+
+#ifdef _OPENMP
+    omp_set_num_threads(max_thread_count);
+#endif
+}
@@ -0,0 +1,73 @@
+// Forward and back substitution of an LU factorization for several
+// right-hand sides at once: systems of size 4 to 512, with 1 to 256
+// right-hand sides of type GLdouble and DCoordinate3, stored as the columns
+// of x. The factorization is computed once, and the times are given per
+// call of LUFactorization::Solve, in microseconds.
+
+#include "Benchmarks.h"
+
+#include "../../Core/DCoordinates3.h"
+#include "../../Core/RealSquareMatrices.h"
+
+#include <cstdio>
+
+using namespace cagd;
+using namespace cagd::benchmarks;
+
+namespace {
+const GLuint rhs_counts[]  = {1, 16, 256};
+const GLuint rhs_count_num = sizeof(rhs_counts) / sizeof(GLuint);
+
+GLdouble Component(const GLdouble &value) { return value; }
+GLdouble Component(const DCoordinate3 &value) { return value[2]; }
+
+// time of a single call of lu.Solve(b, x), in microseconds
+template <class T>
+GLdouble SolveTime(const LUFactorization &lu, const Matrix<T> &b)
+{
+    Matrix<T> x(b.GetRowCount(), b.GetColumnCount());
+
+    GLuint size             = b.GetRowCount();
+    GLuint repetition_count =
+        std::max(1u, (1u << 21) / (size * size * b.GetColumnCount()));
+
+    return MinimumTime(5, [&] {
+               for (GLuint r = 0; r < repetition_count; ++r) {
+                   lu.Solve(b, x);
+                   sink = sink + Component(x(size - 1, 0));
+               }
+           }) *
+           1.0e3 / repetition_count;
+}
+} // namespace
+
+GLvoid cagd::benchmarks::RunMultipleRightHandSidesBenchmark()
+{
+    printf("%6s %10s %14s %14s\n", "size", "rhs count", "GLdouble",
+           "DCoordinate3");
+
+    for (GLuint size = 4; size <= 512; size *= 2) {
+        RealSquareMatrix a(size);
+        for (GLuint i = 0; i < size; ++i)
+            for (GLuint j = 0; j < size; ++j)
+                a(i, j) = (i == j) ? 2.0 * size : 1.0 / (1.0 + i + j);
+
+        std::shared_ptr<const LUFactorization> lu = a.GetLUFactorization();
+
+        for (GLuint c = 0; c < rhs_count_num; ++c) {
+            GLuint rhs_count = rhs_counts[c];
+
+            Matrix<GLdouble>     b(size, rhs_count);
+            Matrix<DCoordinate3> d(size, rhs_count);
+
+            for (GLuint i = 0; i < size; ++i)
+                for (GLuint k = 0; k < rhs_count; ++k) {
+                    b(i, k) = 1.0 + i + k;
+                    d(i, k) = DCoordinate3(i, k, 1.0);
+                }
+
+            printf("%6u %10u %14.3f %14.3f\n", size, rhs_count,
+                   SolveTime(*lu, b), SolveTime(*lu, d));
+        }
+    }
+}
@@ -0,0 +1,74 @@
+// Per-sample costs of the partial derivatives of tensor product surfaces:
+// constructing and clearing a PartialDerivatives object, and generating the
+// isoparametric lines and the mesh of a second order hyperbolic patch,
+// which evaluate one PartialDerivatives object per sample.
+
+#include "Benchmarks.h"
+
+#include "../../Core/GenericCurves3.h"
+#include "../../Core/TriangulatedMeshes3.h"
+#include "../../Hyperbolic/SecondOrderHyperbolicPatch.h"
+
+#include <cmath>
+#include <cstdio>
+
+using namespace cagd;
+
+GLvoid cagd::benchmarks::RunPartialDerivativesBenchmark()
+{
+    const GLuint sample_count = 100000;
+
+    printf("%-44s %12s\n", "PartialDerivatives per sample", "ns");
+
+    for (GLuint order = 1; order <= 4; order *= 2) {
+        GLdouble time = MinimumTime(5, [&] {
+            for (GLuint k = 0; k < sample_count; ++k) {
+                TensorProductSurface3::PartialDerivatives pd(order);
+                pd.LoadNullVectors();
+                sink = sink + pd(order, 0)[0];
+            }
+        });
+
+        printf("  construct and clear, order %u %27.1f\n", order,
+               time * 1.0e6 / sample_count);
+    }
+
+    SecondOrderHyperbolicPatch patch(1.0);
+
+    for (GLuint i = 0; i < 4; ++i)
+        for (GLuint j = 0; j < 4; ++j)
+            patch(i, j) = DCoordinate3(i, j, sin(0.5 * (i + j)));
+
+    printf("%-44s %12s\n", "hyperbolic patch, first order", "ms");
+
+    for (GLuint div_point_count = 100; div_point_count <= 400;
+         div_point_count *= 2) {
+        GLdouble time = MinimumTime(5, [&] {
+            RowMatrix<GenericCurve3 *> *lines =
+                patch.GenerateUIsoparametricLines(10, 1, div_point_count);
+
+            for (GLuint i = 0; i < lines->GetColumnCount(); ++i) {
+                sink = sink + (*(*lines)[i])(0, div_point_count - 1)[0];
+                delete (*lines)[i];
+            }
+
+            delete lines;
+        });
+
+        printf("  10 u-isoparametric lines of %3u points %15.3f\n",
+               div_point_count, time);
+    }
+
+    for (GLuint div_point_count = 100; div_point_count <= 400;
+         div_point_count *= 2) {
+        GLdouble time = MinimumTime(5, [&] {
+            TriangulatedMesh3 *mesh =
+                patch.GenerateImage(div_point_count, div_point_count);
+            sink = sink + mesh->VertexCount();
+            delete mesh;
+        });
+
+        printf("  mesh of %3u x %3u points %29.3f\n", div_point_count,
+               div_point_count, time);
+    }
+}
@@ -0,0 +1,68 @@
+// Construction, copy and traversal of square Matrix<GLdouble> objects of
+// size 4 to 4096. The number of repetitions is chosen such that every size
+// touches about the same number of elements, and the times are given per
+// matrix, in microseconds.
+
+#include "Benchmarks.h"
+
+#include "../../Core/Matrices.h"
+
+#include <cstdio>
+
+using namespace cagd;
+
+GLvoid cagd::benchmarks::RunStorageBenchmark()
+{
+    printf("%6s %14s %14s %14s %14s\n", "size", "construct", "copy",
+           "row sweep", "column sweep");
+
+    for (GLuint size = 4; size <= 4096; size *= 4) {
+        GLuint element_count    = size * size;
+        GLuint repetition_count = std::max(1u, (1u << 22) / element_count);
+
+        GLdouble construct_time = MinimumTime(5, [&] {
+            for (GLuint r = 0; r < repetition_count; ++r) {
+                Matrix<GLdouble> m(size, size);
+                sink = sink + m(size - 1, size - 1);
+            }
+        });
+
+        Matrix<GLdouble> a(size, size);
+        for (GLuint i = 0; i < size; ++i)
+            for (GLuint j = 0; j < size; ++j)
+                a(i, j) = i + 0.5 * j;
+
+        GLdouble copy_time = MinimumTime(5, [&] {
+            for (GLuint r = 0; r < repetition_count; ++r) {
+                Matrix<GLdouble> b(a);
+                sink = sink + b(size - 1, 0);
+            }
+        });
+
+        GLdouble row_time = MinimumTime(5, [&] {
+            for (GLuint r = 0; r < repetition_count; ++r) {
+                GLdouble sum = 0.0;
+                for (GLuint i = 0; i < size; ++i)
+                    for (GLuint j = 0; j < size; ++j)
+                        sum += a(i, j);
+                sink = sink + sum;
+            }
+        });
+
+        GLdouble column_time = MinimumTime(5, [&] {
+            for (GLuint r = 0; r < repetition_count; ++r) {
+                GLdouble sum = 0.0;
+                for (GLuint j = 0; j < size; ++j)
+                    for (GLuint i = 0; i < size; ++i)
+                        sum += a(i, j);
+                sink = sink + sum;
+            }
+        });
+
+        GLdouble scale = 1000.0 / repetition_count;
+
+        printf("%6u %14.3f %14.3f %14.3f %14.3f\n", size,
+               construct_time * scale, copy_time * scale, row_time * scale,
+               column_time * scale);
+    }
+}
@@ -0,0 +1,106 @@
+// Compares the images of cyclic curves that CyclicCurve3::GenerateImage
+// computes by inverse FFTs to their points and derivatives up to order 3
+// evaluated one by one by CalculateDerivatives, i.e., by Clenshaw's
+// recurrence. Transforms of power of two lengths and of other lengths
+// (Bluestein's algorithm) are covered. The program returns EXIT_FAILURE if
+// a relative difference exceeds 1e-12.
+
+#include "../../Core/Constants.h"
+#include "../../Core/FastFourierTransforms.h"
+#include "../../Core/GenericCurves3.h"
+#include "../../Cyclic/CyclicCurves3.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace cagd;
+using namespace std;
+
+namespace {
+GLuint failure_count = 0;
+
+const GLuint   max_order_of_derivatives = 3;
+const GLdouble tolerance                = 1.0e-12;
+
+// compares the derivatives of each order of the image to the ones calculated
+// at its subdivision points, relative to the largest derivative of that order
+GLvoid TestImage(GLuint n, GLuint div_point_count, GLdouble u_min)
+{
+    CyclicCurve3 curve(n);
+    curve.SetDefinitionDomain(u_min, u_min + TWO_PI);
+
+    // control points generated by a linear congruential generator
+    GLuint seed = 12345;
+    for (GLuint i = 0; i < curve.GetDataCount(); ++i) {
+        DCoordinate3 &d = curve[i];
+        for (GLuint c = 0; c < 3; ++c) {
+            seed = 1664525u * seed + 1013904223u;
+            d[c] = 2.0 * seed / 4294967295.0 - 1.0;
+        }
+    }
+
+    // the test is meaningful only if GenerateImage selects the FFT
+    GLboolean uses_fft =
+        (GLdouble)div_point_count * n >=
+        1.5 * FastFourierTransform::GetButterflyCount(div_point_count);
+
+    GenericCurve3 *image =
+        curve.GenerateImage(max_order_of_derivatives, div_point_count);
+
+    LinearCombination3::Derivatives d(max_order_of_derivatives);
+
+    GLdouble difference[max_order_of_derivatives + 1] = {0.0};
+    GLdouble maximum[max_order_of_derivatives + 1]    = {0.0};
+
+    for (GLuint k = 0; image && k < div_point_count; ++k) {
+        curve.CalculateDerivatives(
+            max_order_of_derivatives,
+            curve.GetImageParameterValue(k, div_point_count), d);
+
+        for (GLuint r = 0; r <= max_order_of_derivatives; ++r) {
+            DCoordinate3 delta = (*image)(r, k) - d[r];
+            difference[r]      = max(difference[r], delta.length());
+            maximum[r]         = max(maximum[r], d[r].length());
+        }
+    }
+
+    GLdouble error = 0.0;
+    for (GLuint r = 0; r <= max_order_of_derivatives; ++r)
+        error = max(error, difference[r] / maximum[r]);
+
+    GLboolean failed = !uses_fft || !image || !(error <= tolerance);
+
+    printf("n = %3u, %5u points, u_min = %4.1f %20s %9.2e%s\n", n,
+           div_point_count, u_min, uses_fft ? "relative difference" : "no FFT",
+           error, failed ? "  FAILED" : "");
+
+    if (failed)
+        ++failure_count;
+
+    delete image;
+}
+} // namespace
+
+int main()
+{
+    // power of two lengths
+    TestImage(40, 64, 0.0);
+    TestImage(40, 1024, 0.0);
+    TestImage(100, 4096, 1.5);
+
+    // other lengths, transformed by Bluestein's algorithm
+    TestImage(60, 100, 0.0);
+    TestImage(60, 1001, 0.0);
+    TestImage(100, 997, -2.0);
+
+    if (failure_count) {
+        printf("%u test(s) failed\n", failure_count);
+        return EXIT_FAILURE;
+    }
+
+    printf("all tests passed\n");
+
+    return EXIT_SUCCESS;
+}
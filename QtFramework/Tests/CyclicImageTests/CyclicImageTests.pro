@@ -0,0 +1,8 @@
+# compares the images of cyclic curves generated by inverse FFTs to the
+# points evaluated one by one by Clenshaw's recurrence, the program fails
+# if they differ
+include(../Tests.pri)
+
+TARGET = CyclicImageTests
+
+SOURCES += CyclicImageTests.cpp
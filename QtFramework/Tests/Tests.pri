@@ -0,0 +1,52 @@
+# common settings of the test programs: the non-GUI sources of the framework
+# are compiled into every program, no OpenGL context is created, but the
+# vertex buffer object methods still have to be linked
+
+TEMPLATE = app
+CONFIG += console c++14
+CONFIG -= app_bundle
+QT -= core gui
+
+FRAMEWORK = $$PWD/..
+
+INCLUDEPATH += $$FRAMEWORK/Dependencies/Include
+DEPENDPATH += $$FRAMEWORK/Dependencies/Include
+
+win32 {
+    LIBS += -lopengl32 -lglu32
+
+    contains(QT_ARCH, i386) {
+        LIBS += -L"$$FRAMEWORK/Dependencies/Lib/GL/x86/" -lglew32
+    } else {
+        LIBS += -L"$$FRAMEWORK/Dependencies/Lib/GL/x86_64/" -lglew32
+    }
+
+    msvc {
+      QMAKE_CXXFLAGS += -openmp -arch:AVX -D "_CRT_SECURE_NO_WARNINGS"
+      QMAKE_CXXFLAGS_RELEASE *= -O2
+    }
+}
+
+unix {
+    LIBS += -lGLEW -lGLU -lGL
+}
+
+linux {
+    QMAKE_CXXFLAGS += -fopenmp
+    LIBS += -fopenmp
+}
+
+SOURCES += \
+    $$FRAMEWORK/Core/RealSquareMatrices.cpp \
+    $$FRAMEWORK/Core/BandedSquareMatrices.cpp \
+    $$FRAMEWORK/Core/FastFourierTransforms.cpp \
+    $$FRAMEWORK/Core/LinearCombination3.cpp \
+    $$FRAMEWORK/Core/GenericCurves3.cpp \
+    $$FRAMEWORK/Core/CurveBatches3.cpp \
+    $$FRAMEWORK/Core/TriangulatedMeshes3.cpp \
+    $$FRAMEWORK/Core/TensorProductSurfaces3.cpp \
+    $$FRAMEWORK/Parametric/ParametricCurves3.cpp \
+    $$FRAMEWORK/Parametric/ParametricSurfaces3.cpp \
+    $$FRAMEWORK/Cyclic/CyclicCurves3.cpp \
+    $$FRAMEWORK/BSpline/BSplineCurves3.cpp \
+    $$FRAMEWORK/Hyperbolic/SecondOrderHyperbolicPatch.cpp
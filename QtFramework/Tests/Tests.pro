@@ -0,0 +1,8 @@
+# console programs that check and measure the framework without its GUI,
+# build them in release mode before reading the timings
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    AllocationTests \
+    CyclicImageTests \
+    Benchmarks